@@ -1,11 +1,50 @@
 #include "Winplus_defines.hpp"
 #include "Winplus_types.hpp"
+#include <filesystem>
+#include <memory_resource>
+#include <optional>
 #include <print>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#ifndef WINPLUS_CONF_COMPILER_H
+#define WINPLUS_CONF_COMPILER_H
+
 namespace winplus::compiler {
 namespace lexer {
+/**
+ * A line and column position in the source code, both starting at 1.
+ */
+struct SourceLocation {
+  u32 line;
+  u32 column;
+};
+
+/**
+ * Maps byte offsets in the source code to line and column positions.
+ *
+ * The map records the offset at which every line starts, found with a single
+ * `memchr` scan for line breaks, and resolves offsets by binary search. Tokens
+ * only carry offsets, so the map is built the first time a location is needed,
+ * which is usually when reporting a diagnostic. The line table is allocated
+ * from `resource`.
+ */
+class WINPLUS_API SourceMap {
+public:
+  explicit SourceMap(std::string_view source,
+                     std::pmr::memory_resource *resource =
+                         std::pmr::get_default_resource());
+
+  /** Returns the line and column of the given byte offset. */
+  SourceLocation locate(u32 offset) const;
+
+private:
+  std::pmr::vector<u32> lineStarts_;
+};
+
 /**
  * A lexical token.
  *
@@ -37,33 +76,49 @@ public:
   /**
    * Represents a lexical token.
    *
-   * A Token holds the type, lexeme, and line number information for a lexical
-   * element in the source code. The 'type' indicates the category of the token,
-   * such as a keyword or identifier. The 'lexeme' is the exact substring from
-   * the source code that matches the token. The 'line' specifies the line
-   * number in the source code where the token is located.
+   * A Token holds the type and position of a lexical element in the source
+   * code. The 'type' indicates the category of the token, such as a keyword
+   * or identifier. 'offset' and 'length' locate the exact substring of the
+   * source code that matches the token; `Lexer::lexeme()` returns it and
+   * `Lexer::location()` turns the offset into a line and column. For integer
+   * literals 'value' holds the decoded number, so it never has to be parsed
+   * again; for error tokens it indexes the message returned by
+   * `Lexer::message()`. Tokens own no memory, so tokenizing allocates nothing
+   * but the token vector.
    */
   struct Token {
+    u64 value;
     TokenType type;
-    string lexeme;
-    int line;
+    u32 offset;
+    u32 length;
 
-    Token(TokenType t, std::string l, int ln)
-        : type(t), lexeme(std::move(l)), line(ln) {}
+    Token(TokenType t, u32 o, u32 l, u64 v = 0)
+        : value(v), type(t), offset(o), length(l) {}
   };
 
-  explicit Lexer(const std::string &source)
-      : source_(source), current_(0), start_(0), line_(1) {}
+  /**
+   * Creates a lexer over a copy of the given source code.
+   *
+   * The source copy, the error messages, the token vector and the source map
+   * are allocated from `resource`, so a whole compile can run in one arena
+   * that is released at once. The resource must outlive the lexer and its
+   * tokens, and tokens are only meaningful together with the lexer that
+   * produced them.
+   */
+  explicit Lexer(std::string_view source,
+                 std::pmr::memory_resource *resource =
+                     std::pmr::get_default_resource())
+      : source_(source, resource), current_(0), start_(0),
+        resource_(resource), messages_(resource) {}
 
   /**
    * Scans the source code from the current position and returns the next token.
    *
    * This function advances the current position in the source code and returns
    * the next Token in the stream. The type of the returned token is determined
-   * by the next sequence of characters in the source code. The lexeme of the
-   * returned token is the exact substring from the source code that matches the
-   * token. The line number of the returned token is the line number in the
-   * source code where the token is located.
+   * by the next sequence of characters in the source code. The offset and
+   * length of the returned token locate the exact substring from the source
+   * code that matches the token.
    */
   Token nextToken();
 
@@ -136,8 +191,8 @@ public:
    *
    * This function processes a string literal, capturing all characters between
    * the opening and closing quotes. If the string is unterminated, it returns
-   * an error token. The function also handles line breaks within strings
-   * by incrementing the line counter.
+   * an error token. Line breaks within strings are kept as part of the
+   * value.
    */
   Token string();
 
@@ -145,8 +200,10 @@ public:
    * Extracts and returns an integer literal token from the source code.
    *
    * This function processes an integer literal, capturing all contiguous digits
-   * in the source code. The function also handles radix specifiers, such as
-   * hexadecimal and octal literals.
+   * in the source code. The function also handles radix specifiers: `0x` for
+   * hexadecimal, `0o` for octal and `0b` for binary literals. The decoded
+   * value is stored in the token; literals that are malformed or do not fit
+   * in 64 bits produce an error token.
    */
   Token number();
 
@@ -189,9 +246,10 @@ public:
    *
    * This function is used to report errors to the user. The function takes a
    * string message as input and returns a token with the type TokenType::ERROR
-   * and the given message. The token is used to report errors to the user.
+   * covering the offending text. The message is kept by the lexer and returned
+   * by `message()`.
    */
-  Token errorToken(const std::string &message);
+  Token errorToken(std::string_view message);
 
   /**
    * Tokenizes the entire source code into a vector of tokens.
@@ -201,13 +259,34 @@ public:
    * end of the file or encounters an error token. If an error token is encountered,
    * it will be included as the last token in the returned vector.
    */
-  std::vector<Token> tokenize();
+  std::pmr::vector<Token> tokenize();
+
+  /**
+   * Returns the line and column of a byte offset in the source code.
+   *
+   * Used to turn a token offset into a position for diagnostics. The source
+   * map is built on the first call and reused afterwards.
+   */
+  SourceLocation location(u32 offset) const;
+
+  /**
+   * Returns the text of a token produced by this lexer.
+   *
+   * The view points into the lexer's copy of the source code. String literals
+   * are returned without their quotes.
+   */
+  std::string_view lexeme(const Token &token) const;
+
+  /** Returns the message of an error token produced by this lexer. */
+  std::string_view message(const Token &token) const;
 
 private:
-  std::string source_;
+  std::pmr::string source_;
   size_t current_;
   size_t start_;
-  int line_;
+  std::pmr::memory_resource *resource_;
+  std::pmr::vector<std::pmr::string> messages_;
+  mutable std::optional<SourceMap> sourceMap_;
 };
 
 } // namespace lexer
@@ -220,16 +299,78 @@ struct EnumEntry {
   winplus::string type;
   winplus::string title;
   u16 enumId;
+
+  bool operator==(const EnumEntry &other) const = default;
+};
+
+/**
+ * An error found in the source code.
+ *
+ * 'offset' is the byte offset of the offending token and 'location' its line
+ * and column.
+ */
+struct Diagnostic {
+  u32 offset;
+  lexer::SourceLocation location;
+  winplus::string message;
+};
+
+/**
+ * Where the numbers of a parsed entry are in the source code.
+ *
+ * Byte offsets of the enumeration ID and of the 'id' value, so an entry that
+ * reuses a number can be reported at the number.
+ */
+struct EntryOffsets {
+  u32 enumId;
+  u32 id;
+};
+
+/**
+ * Error thrown while parsing an enumeration.
+ *
+ * Carries the offset of the token the error was found at, so the parser can
+ * turn it into a `Diagnostic`.
+ */
+class ParseError : public std::runtime_error {
+public:
+  ParseError(const std::string &message, u32 offset)
+      : std::runtime_error(message), offset_(offset) {}
+
+  /** Returns the byte offset of the offending token. */
+  u32 offset() const { return offset_; }
+
+private:
+  u32 offset_;
 };
 
 
 class WINPLUS_API Parser {
 public:
-  explicit Parser(const std::vector<lexer::Lexer::Token>& tokens) 
-    : tokens_(tokens), current_(0) {}
+  /**
+   * Creates a parser over the given tokens.
+   *
+   * `lexer` is the lexer the tokens came from; the parser reads token text and
+   * error messages from it and resolves diagnostics to lines and columns.
+   */
+  Parser(std::span<const lexer::Lexer::Token> tokens,
+         const lexer::Lexer &lexer)
+    : tokens_(tokens), lexer_(lexer), current_(0) {}
 
+  /**
+   * Parses every enumeration in the token stream.
+   *
+   * Malformed enumerations are skipped up to the next 'enumeration' keyword
+   * and reported in `diagnostics()`, as is an error token of the lexer.
+   */
   std::vector<EnumEntry> parse();
 
+  /** Returns the errors found by `parse()`, in source order. */
+  const std::vector<Diagnostic> &diagnostics() const { return diagnostics_; }
+
+  /** Returns the offsets of every entry returned by `parse()`, in order. */
+  const std::vector<EntryOffsets> &offsets() const { return offsets_; }
+
 private:
   /**
    * Parses an enumeration declaration from the token stream.
@@ -245,9 +386,20 @@ private:
    *
    *       id: [number]
    *
-   * The function returns an EnumEntry containing the parsed values.
+   * The function returns an EnumEntry containing the parsed values and stores
+   * the offsets of its numbers in `offsets`.
    */
-  EnumEntry parseEnumeration();
+  EnumEntry parseEnumeration(EntryOffsets &offsets);
+
+  /**
+   * Returns the value of an integer literal token, checked against a maximum.
+   *
+   * Used to narrow decoded literals into the width of the field they are
+   * stored in. Throws a `ParseError` at the token with the given message if
+   * the value is greater than `max`.
+   */
+  u64 checkRange(const lexer::Lexer::Token &token, u64 max,
+                 const std::string &message) const;
 
   /**
    * Peeks at the next token in the token stream without consuming it.
@@ -256,7 +408,7 @@ private:
    * without advancing the `current_` index. If the end of input has been
    * reached, returns the last token.
    */
-  lexer::Lexer::Token peek() const;
+  const lexer::Lexer::Token &peek() const;
 
   /**
    * Advances the current position in the token stream by one token.
@@ -265,7 +417,7 @@ private:
    * increments the `current_` index to point to the next token. If the
    * end of the input has been reached, returns the last token.
    */
-  lexer::Lexer::Token advance();
+  const lexer::Lexer::Token &advance();
 
   /**
    * Checks if the next token in the token stream matches the given type.
@@ -283,9 +435,10 @@ private:
    * given type. If it does, the function returns the consumed token and
    * advances the `current_` index to point to the next token. If the end of the
    * input has been reached, or if the next token does not match the given type,
-   * this function throws an std::runtime_error with the given message.
+   * this function throws a `ParseError` at the next token with the given
+   * message, or with the lexer's message if the next token is an error token.
    */
-  lexer::Lexer::Token consume(lexer::Lexer::TokenType type, const std::string& message);
+  const lexer::Lexer::Token &consume(lexer::Lexer::TokenType type, const std::string& message);
 
   /**
    * Checks if the current token is at the end of the token stream.
@@ -295,10 +448,44 @@ private:
    */
   bool isAtEnd() const;
 
-  const std::vector<lexer::Lexer::Token>& tokens_;
+  /** Records an error at the given offset. */
+  void report(u32 offset, const std::string &message);
+
+  std::span<const lexer::Lexer::Token> tokens_;
+  const lexer::Lexer &lexer_;
   size_t current_;
+  std::vector<Diagnostic> diagnostics_;
+  std::vector<EntryOffsets> offsets_;
 };
 
 } // namespace parser
 
-} // namespace winplus::compiler
\ No newline at end of file
+/**
+ * Compiles conf source code into enumeration entries.
+ *
+ * Runs the lexer and the parser over the given source and returns the parsed
+ * entries. Malformed enumerations are skipped the same way `Parser::parse()`
+ * skips them; if `diagnostics` is given, the errors found are appended to it
+ * with their line and column. The source copy and the tokens are allocated
+ * from `resource`; the returned entries are not, so they outlive it.
+ */
+WINPLUS_API std::vector<parser::EnumEntry>
+Compile(std::string_view source,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+        std::vector<parser::Diagnostic> *diagnostics = nullptr);
+
+/**
+ * Reads a conf file from disk and compiles it.
+ *
+ * Errors in the file are reported the same way `Compile()` reports them.
+ * Throws an std::runtime_error if the file cannot be opened.
+ */
+WINPLUS_API std::vector<parser::EnumEntry>
+CompileFile(const std::filesystem::path &path,
+            std::pmr::memory_resource *resource =
+                std::pmr::get_default_resource(),
+            std::vector<parser::Diagnostic> *diagnostics = nullptr);
+
+} // namespace winplus::compiler
+
+#endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "Winplus.conf_compiler.hpp"
+#include "Winplus_defines.hpp"
+#include "Winplus_types.hpp"
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef WINPLUS_CONF_MEMORY_H
+#define WINPLUS_CONF_MEMORY_H
+
+namespace winplus::compiler::memory {
+
+/**
+ * Allocation counters of a memory resource.
+ *
+ * `bytes` and `allocations` count what was requested in total, `peak` is the
+ * largest number of bytes that were live at the same time.
+ */
+struct AllocationStats {
+  u64 bytes = 0;
+  u64 allocations = 0;
+  u64 deallocations = 0;
+  u64 peak = 0;
+};
+
+/**
+ * Allocation counters of one named compile phase.
+ */
+struct PhaseStats {
+  std::string name;
+  AllocationStats stats;
+};
+
+/**
+ * A memory resource that counts the allocations passing through it.
+ *
+ * Forwards every request to an upstream resource and records bytes,
+ * allocation counts and peak usage, both in total and for the phase started
+ * by the last `beginPhase()` call. Like the standard pool resources it is not
+ * thread safe.
+ *
+ * `peak` assumes the upstream reuses what is deallocated. Above a
+ * `std::pmr::monotonic_buffer_resource`, which never does, it under-reports
+ * what the arena consumed; count the arena's own upstream for that instead.
+ */
+class WINPLUS_API CountingResource : public std::pmr::memory_resource {
+public:
+  explicit CountingResource(std::pmr::memory_resource *upstream =
+                                std::pmr::get_default_resource())
+      : upstream_(upstream), live_(0) {}
+
+  /**
+   * Starts a new phase.
+   *
+   * Allocations made from now on are attributed to the phase with the given
+   * name until the next call.
+   */
+  void beginPhase(std::string name);
+
+  /** Returns the counters since construction or the last `reset()`. */
+  const AllocationStats &stats() const { return total_; }
+
+  /** Returns the counters of every phase, in the order they were started. */
+  const std::vector<PhaseStats> &phases() const { return phases_; }
+
+  /** Clears all counters and phases. */
+  void reset();
+
+private:
+  void *do_allocate(sz bytes, sz alignment) override;
+  void do_deallocate(void *p, sz bytes, sz alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override;
+
+  std::pmr::memory_resource *upstream_;
+  u64 live_;
+  AllocationStats total_;
+  std::vector<PhaseStats> phases_;
+};
+
+/**
+ * Where the numbers of a compiled entry are in the source code.
+ */
+struct EntryLocation {
+  lexer::SourceLocation enumId; /**< The enumeration ID. */
+  lexer::SourceLocation id;     /**< The 'id' value. */
+};
+
+/**
+ * Result of a compile that ran in an arena.
+ */
+struct CompileReport {
+  std::vector<parser::EnumEntry> entries;      /**< Compiled entries. */
+  std::vector<EntryLocation> locations;        /**< Per entry, in order. */
+  std::vector<parser::Diagnostic> diagnostics; /**< Errors in the source. */
+  AllocationStats total;          /**< Requests made to the arena. */
+  std::vector<PhaseStats> phases; /**< Requests made to the arena per phase. */
+  AllocationStats arena;  /**< Buffers the arena took from the heap. */
+  AllocationStats output; /**< Heap memory held by the results. */
+};
+
+/**
+ * Compiles conf source code in a monotonic arena and reports its usage.
+ *
+ * The source copy, the tokens, the lexer's error messages and the source map
+ * are allocated from one `std::pmr::monotonic_buffer_resource` that is
+ * released at once when the compile is done. `total.bytes` is what the
+ * `source`, `lex` and `parse` phases requested, including memory a growing
+ * token vector gave back, which the arena never reuses; the `parse` phase
+ * holds the line table built to locate entries and diagnostics.
+ * `arena.bytes` is what the arena really took from the heap, its initial
+ * buffer included.
+ *
+ * The returned results must outlive the arena, so they are allocated from the
+ * heap. `output` counts the blocks they hold when the compile returns: the
+ * result vectors and every string too long for its inline buffer. Memory the
+ * vectors gave back while growing is not included.
+ *
+ * An `initialSize` slightly above `total.bytes` of a comparable source, to
+ * leave room for alignment and the arena's bookkeeping, lets the arena get by
+ * with its initial buffer; `arena.allocations` above one shows it had to grow.
+ */
+WINPLUS_API CompileReport CompileInArena(std::string_view source,
+                                         sz initialSize = 4096);
+
+} // namespace winplus::compiler::memory
+
+#endif
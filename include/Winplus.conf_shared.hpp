@@ -0,0 +1,140 @@
+#include "Winplus.conf_compiler.hpp"
+#include "Winplus.conf_table.hpp"
+#include "Winplus_defines.hpp"
+#include "Winplus_types.hpp"
+#include <atomic>
+#include <span>
+#include <string>
+
+#ifndef WINPLUS_CONF_SHARED_H
+#define WINPLUS_CONF_SHARED_H
+
+namespace winplus::compiler::shared {
+
+/** Identifies a shared table control block, "WPSC" in little endian. */
+constexpr u32 SHARED_MAGIC = 0x43535057;
+
+/**
+ * Control block at the start of the `<name>` shared memory segment.
+ *
+ * Holds the version of the table currently published under `<name>.<version>`.
+ * The publisher stores a new version only after the table segment is fully
+ * written, so readers that load it never see a partial table. A version of 0
+ * means nothing is published.
+ */
+struct SharedControl {
+  u32 magic;
+  u32 reserved;
+  std::atomic<u64> version;
+};
+
+static_assert(std::atomic<u64>::is_always_lock_free,
+              "SharedControl::version must be usable across processes");
+
+/**
+ * Publishes compiled tables into named shared memory.
+ *
+ * Every published version is a compiled table (see `table::BuildTable`) in
+ * its own segment, so readers in other processes map one physical copy and do
+ * lookups without parsing. Only one publisher per name should exist at a
+ * time. The name may carry a `Global\` or `Local\` prefix.
+ *
+ * The segments are backed by the paging file, so each one exists only while
+ * some process holds a handle to it. The publisher holds the current table,
+ * so it must stay alive for as long as new readers should be able to open the
+ * table. Readers that already mapped a version keep it after the publisher is
+ * gone. When it is destroyed, the publisher withdraws its version, and new
+ * readers then fail to open the name instead of looking for a segment that no
+ * longer exists. A publisher that crashes cannot withdraw its version; readers
+ * see a version they cannot map and treat it as nothing published.
+ */
+class WINPLUS_API SharedTablePublisher {
+public:
+  /**
+   * Opens or creates the control segment of the given name.
+   *
+   * Throws an std::runtime_error if the segment cannot be created.
+   */
+  explicit SharedTablePublisher(std::string name);
+
+  /** Withdraws the published version and closes the current table. */
+  ~SharedTablePublisher();
+
+  SharedTablePublisher(const SharedTablePublisher &) = delete;
+  SharedTablePublisher &operator=(const SharedTablePublisher &) = delete;
+
+  /**
+   * Publishes a new version of the entries.
+   *
+   * Writes the table into a new segment and then switches readers to it by
+   * storing its version in the control block. The previous segment stays
+   * alive for as long as a reader still maps it. A version whose segment
+   * still exists, left behind by an earlier publisher, is skipped rather than
+   * overwritten. Returns the new version, or throws an std::runtime_error if
+   * the segment cannot be created.
+   */
+  u64 publish(std::span<const parser::EnumEntry> entries);
+
+  /** Returns the version of the currently published table. */
+  u64 version() const { return control_->version.load(); }
+
+private:
+  std::string name_;
+  void *controlMapping_;
+  SharedControl *control_;
+  void *tableMapping_;
+};
+
+/**
+ * Maps the table published under a name read-only.
+ *
+ * Lookups go through `table()` and read the shared segment directly. A
+ * segment is only used after its table was validated within the size of the
+ * mapped region. A reader keeps its mapped version until `refresh()` switches
+ * to a newer one; lookups must not run concurrently with `refresh()` on the
+ * same reader.
+ */
+class WINPLUS_API SharedTableReader {
+public:
+  /**
+   * Opens the control segment of the given name and maps the current table.
+   *
+   * Throws an std::runtime_error if nothing is published under the name,
+   * including when its publisher is gone.
+   */
+  explicit SharedTableReader(std::string name);
+  ~SharedTableReader();
+
+  SharedTableReader(const SharedTableReader &) = delete;
+  SharedTableReader &operator=(const SharedTableReader &) = delete;
+
+  /**
+   * Switches to the newest published table.
+   *
+   * Returns true if a newer version was mapped, false if the mapped version is
+   * still current or nothing can be mapped because the publisher is gone; the
+   * mapped table stays usable in both cases.
+   */
+  bool refresh();
+
+  /** Returns the mapped table. */
+  const table::TableView &table() const { return table_; }
+
+  /** Returns the version of the mapped table. */
+  u64 version() const { return table_.version(); }
+
+private:
+  bool map(u64 version);
+  void unmap();
+
+  std::string name_;
+  void *controlMapping_;
+  const SharedControl *control_;
+  void *tableMapping_;
+  const void *tableView_;
+  table::TableView table_;
+};
+
+} // namespace winplus::compiler::shared
+
+#endif
@@ -0,0 +1,166 @@
+#include "Winplus.conf_compiler.hpp"
+#include "Winplus_defines.hpp"
+#include "Winplus_types.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef WINPLUS_CONF_SNAPSHOT_H
+#define WINPLUS_CONF_SNAPSHOT_H
+
+namespace winplus::compiler::snapshot {
+
+/**
+ * An immutable version of the compiled entries.
+ *
+ * The entries are sorted by enumeration number and indexed by id once on
+ * construction, so lookups are binary searches over data that never changes.
+ * A snapshot can be read from any number of threads without synchronization.
+ */
+class WINPLUS_API ConfSnapshot {
+public:
+  ConfSnapshot(std::vector<parser::EnumEntry> entries, u64 version);
+
+  /** Returns the version the snapshot was published as. */
+  u64 version() const { return version_; }
+
+  /** Returns all entries, sorted by enumeration number. */
+  const std::vector<parser::EnumEntry> &entries() const { return entries_; }
+
+  /**
+   * Looks up an entry by its enumeration number.
+   *
+   * Returns a pointer into the snapshot, or nullptr if there is no such entry.
+   * The pointer stays valid as long as the snapshot is held.
+   */
+  const parser::EnumEntry *findByEnumId(u16 enumId) const;
+
+  /**
+   * Looks up an entry by its id.
+   *
+   * Returns a pointer into the snapshot, or nullptr if there is no such entry.
+   * The pointer stays valid as long as the snapshot is held.
+   */
+  const parser::EnumEntry *findById(u32 id) const;
+
+private:
+  std::vector<parser::EnumEntry> entries_;
+  std::vector<u32> byId_;
+  u64 version_;
+};
+
+/**
+ * Holds the current snapshot of the compiled entries.
+ *
+ * Readers call `read()` for a short lookup or `acquire()` to keep the current
+ * snapshot; writers call `publish()` to atomically replace it. A replaced
+ * snapshot is freed once no reader can reach it any more, so readers never
+ * observe a half-updated table and never block writers.
+ *
+ * Neither read takes a lock or retries: the reader announces itself in one of
+ * `READER_SLOTS` striped counters, one cache line per thread, and loads the
+ * current pointer. It is wait-free wherever atomic increments are, which
+ * includes x86 and ARMv8.1 targets. `read()` touches nothing but that
+ * thread's counter, so lookups from any number of threads share no cache
+ * line. `acquire()` also copies the `shared_ptr`, whose reference count is
+ * one cache line shared by every thread that acquires the same snapshot.
+ * `publish()` waits for the readers that may still see the old pointer to
+ * leave their counters before dropping the store's reference to it.
+ *
+ * Feeding the store from a `watch::ConfWatcher` is a matter of publishing
+ * `ReloadEvent::entries` from a subscriber.
+ */
+class WINPLUS_API SnapshotStore {
+public:
+  /** Number of counters readers are spread over to avoid contention. */
+  static constexpr sz READER_SLOTS = 64;
+
+  SnapshotStore();
+  ~SnapshotStore();
+
+  SnapshotStore(const SnapshotStore &) = delete;
+  SnapshotStore &operator=(const SnapshotStore &) = delete;
+
+  /**
+   * Access to the current snapshot for the lifetime of the guard.
+   *
+   * Keeps the reader announced in its counter, so the snapshot cannot be
+   * freed while the guard exists. A `publish()` waits for every guard that
+   * may see the snapshot it replaces, so guards must be short-lived.
+   */
+  class ReadGuard {
+  public:
+    ReadGuard(const ReadGuard &) = delete;
+    ReadGuard &operator=(const ReadGuard &) = delete;
+    ~ReadGuard() { active_.fetch_sub(1, std::memory_order_release); }
+
+    const ConfSnapshot &operator*() const { return *snapshot_; }
+    const ConfSnapshot *operator->() const { return snapshot_; }
+
+  private:
+    friend class SnapshotStore;
+
+    ReadGuard(std::atomic<u64> &active, const ConfSnapshot *snapshot)
+        : active_(active), snapshot_(snapshot) {}
+
+    std::atomic<u64> &active_;
+    const ConfSnapshot *snapshot_;
+  };
+
+  /**
+   * Returns a guard over the current snapshot.
+   *
+   * The fast path for lookups: it does not touch the snapshot's reference
+   * count. Use `acquire()` to keep a snapshot beyond a short lookup.
+   */
+  ReadGuard read() const;
+
+  /**
+   * Returns the current snapshot.
+   *
+   * The returned snapshot stays valid and unchanged for as long as the caller
+   * holds it, even if newer versions are published in the meantime.
+   */
+  std::shared_ptr<const ConfSnapshot> acquire() const;
+
+  /**
+   * Publishes a new version of the entries.
+   *
+   * Builds a new snapshot from the given entries and makes it the current one.
+   * Returns the version of the published snapshot once no reader can still
+   * reach the previous one through the store.
+   */
+  u64 publish(std::vector<parser::EnumEntry> entries);
+
+  /** Returns the version of the current snapshot. */
+  u64 version() const { return read()->version(); }
+
+private:
+  using Pointer = std::shared_ptr<const ConfSnapshot>;
+
+  // Readers inside `read()` guards or `acquire()`, counted separately for both
+  // epoch parities so a writer waits only for readers that entered before it
+  // flipped the epoch.
+  struct alignas(64) ReaderSlot {
+    std::atomic<u64> active[2] = {0, 0};
+  };
+
+  static_assert(std::atomic<u64>::is_always_lock_free,
+                "Reader counters must not fall back to a lock");
+  static_assert(std::atomic<const Pointer *>::is_always_lock_free,
+                "The current pointer must not fall back to a lock");
+
+  std::atomic<u64> &enter() const;
+  void synchronize();
+
+  std::atomic<const Pointer *> current_;
+  std::atomic<u32> epoch_;
+  mutable std::array<ReaderSlot, READER_SLOTS> readers_;
+  std::mutex publishMutex_;
+};
+
+} // namespace winplus::compiler::snapshot
+
+#endif
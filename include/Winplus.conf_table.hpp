@@ -0,0 +1,122 @@
+#include "Winplus.conf_compiler.hpp"
+#include "Winplus_defines.hpp"
+#include "Winplus_types.hpp"
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#ifndef WINPLUS_CONF_TABLE_H
+#define WINPLUS_CONF_TABLE_H
+
+namespace winplus::compiler::table {
+
+/** Identifies a compiled table, "WPCT" in little endian. */
+constexpr u32 TABLE_MAGIC = 0x54435057;
+
+/** Layout version of the compiled table format. */
+constexpr u16 TABLE_FORMAT = 1;
+
+/**
+ * Header at the start of a compiled table.
+ *
+ * All offsets are relative to the start of the table, so a table can be
+ * written to disk or mapped at any address and read without fixups.
+ */
+struct TableHeader {
+  u32 magic;         /**< Always TABLE_MAGIC. */
+  u16 format;        /**< Always TABLE_FORMAT. */
+  u16 reserved;      /**< Zero. */
+  u64 version;       /**< Version of the table contents. */
+  u32 entryCount;    /**< Number of entries. */
+  u32 entriesOffset; /**< Offset of the TableEntry array. */
+  u32 idIndexOffset; /**< Offset of the u32 index array sorted by id. */
+  u32 stringsOffset; /**< Offset of the string pool. */
+  u32 stringsSize;   /**< Size of the string pool in bytes. */
+  u32 totalSize;     /**< Size of the whole table in bytes. */
+};
+
+/**
+ * One entry of a compiled table.
+ *
+ * Strings are stored as offset and length into the string pool. Equal
+ * strings are interned, so every entry of the same type points at the same
+ * bytes.
+ */
+struct TableEntry {
+  u32 id;
+  u16 enumId;
+  u16 reserved;
+  u32 typeOffset;
+  u32 typeLength;
+  u32 titleOffset;
+  u32 titleLength;
+};
+
+/**
+ * Serializes entries into a compiled table.
+ *
+ * Entries are sorted by enumeration number and an index sorted by id is
+ * appended, so both lookups of `TableView` are binary searches. Returns the
+ * bytes of the table.
+ */
+WINPLUS_API std::vector<char> BuildTable(
+    std::span<const parser::EnumEntry> entries, u64 version = 0);
+
+/**
+ * Read-only view over the bytes of a compiled table.
+ *
+ * The view does not own the bytes; they must stay alive and unchanged for as
+ * long as the view and the string views it returns are used.
+ */
+class WINPLUS_API TableView {
+public:
+  /** An entry whose strings point into the table. */
+  struct Entry {
+    u32 id;
+    u16 enumId;
+    std::string_view type;
+    std::string_view title;
+  };
+
+  TableView()
+      : header_(nullptr), entries_(nullptr), idIndex_(nullptr),
+        strings_(nullptr) {}
+
+  /**
+   * Creates a view over a compiled table.
+   *
+   * Checks that every offset, string range and index of the table lies within
+   * `bytes`, so lookups on the view never read outside of it. Throws an
+   * std::runtime_error if the bytes are not a valid table.
+   */
+  explicit TableView(std::span<const char> bytes);
+
+  /** Returns the number of entries. */
+  u32 size() const { return header_ ? header_->entryCount : 0; }
+
+  /** Returns the version stored in the table header. */
+  u64 version() const { return header_ ? header_->version : 0; }
+
+  /** Returns the entry at the given index, in enumeration number order. */
+  Entry at(u32 index) const;
+
+  /** Looks up an entry by its enumeration number. */
+  std::optional<Entry> findByEnumId(u16 enumId) const;
+
+  /** Looks up an entry by its id. */
+  std::optional<Entry> findById(u32 id) const;
+
+  /** Decodes all entries into owning EnumEntry values. */
+  std::vector<parser::EnumEntry> entries() const;
+
+private:
+  const TableHeader *header_;
+  const TableEntry *entries_;
+  const u32 *idIndex_;
+  const char *strings_;
+};
+
+} // namespace winplus::compiler::table
+
+#endif
@@ -0,0 +1,156 @@
+#include "Winplus.conf_compiler.hpp"
+#include "Winplus_defines.hpp"
+#include "Winplus_types.hpp"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef WINPLUS_CONF_WATCH_H
+#define WINPLUS_CONF_WATCH_H
+
+namespace winplus::compiler::watch {
+
+/**
+ * Difference between two versions of the compiled entries.
+ *
+ * Entries are matched by their enumeration number. An entry whose enumeration
+ * number only exists in the new version is added, one that only exists in the
+ * old version is removed, and one that exists in both with different fields is
+ * changed (the new value is stored).
+ */
+struct EntryDiff {
+  std::vector<parser::EnumEntry> added;
+  std::vector<parser::EnumEntry> removed;
+  std::vector<parser::EnumEntry> changed;
+
+  /** Returns true if nothing was added, removed or changed. */
+  bool empty() const {
+    return added.empty() && removed.empty() && changed.empty();
+  }
+};
+
+/**
+ * Describes one hot reload.
+ *
+ * Passed to every subscriber after a burst of writes has settled and the
+ * changed files were recompiled. `entries` holds the full entry set of all
+ * watched files, `diff` only what changed in this reload.
+ */
+struct ReloadEvent {
+  std::vector<std::filesystem::path> files; /**< Recompiled files. */
+  std::vector<parser::EnumEntry> entries; /**< Entries of all watched files. */
+  EntryDiff diff;                         /**< Changes since last reload. */
+  std::chrono::microseconds latency;     /**< First write seen to reload. */
+  std::chrono::microseconds compileTime; /**< Time spent recompiling. */
+};
+
+/**
+ * Watches conf files and recompiles them when they change on disk.
+ *
+ * The watcher listens to directory change notifications of the directories
+ * containing the watched files on a background thread. Writes are debounced:
+ * a reload happens once no write to a watched file has been seen for the
+ * debounce interval, and only the files written to in that burst are
+ * recompiled. A file that does not compile cleanly, usually because it is
+ * still being written, keeps its previous entries until a later write fixes
+ * it. A directory that can no longer be watched has its files reloaded once
+ * and is then dropped. Subscribers are notified on the watcher thread, and
+ * only when at least one file was recompiled.
+ *
+ * Paths are kept as wide strings and compared case-insensitively, the way the
+ * Windows file system resolves them.
+ */
+class WINPLUS_API ConfWatcher {
+public:
+  using Callback = std::function<void(const ReloadEvent &)>;
+
+  explicit ConfWatcher(
+      std::chrono::milliseconds debounce = std::chrono::milliseconds(50));
+  ~ConfWatcher();
+
+  ConfWatcher(const ConfWatcher &) = delete;
+  ConfWatcher &operator=(const ConfWatcher &) = delete;
+
+  /**
+   * Adds a conf file to the watch list and compiles it.
+   *
+   * Must be called before `start()`; files added while the watcher is running
+   * are only watched after a restart. Throws an std::runtime_error if the file
+   * cannot be opened or does not compile cleanly.
+   */
+  void addFile(const std::filesystem::path &path);
+
+  /**
+   * Registers a callback invoked after every reload.
+   *
+   * Returns a handle that can be passed to `unsubscribe()`.
+   */
+  u32 subscribe(Callback callback);
+
+  /** Removes a callback registered with `subscribe()`. */
+  void unsubscribe(u32 handle);
+
+  /**
+   * Starts the watcher thread.
+   *
+   * Throws an std::runtime_error if the watched files span more directories
+   * than can be waited on at once.
+   */
+  void start();
+
+  /** Stops the watcher thread and waits for it to finish. */
+  void stop();
+
+  /**
+   * Recompiles the given watched files and notifies subscribers.
+   *
+   * This is what the watcher thread calls once a burst of writes settles, and
+   * can be called directly to force a reload. Files that cannot be read or
+   * have compile errors are left at their previous entries. Paths that are not
+   * watched are ignored.
+   */
+  void reload(const std::vector<std::filesystem::path> &paths);
+
+  /** Returns the current entries of all watched files. */
+  std::vector<parser::EnumEntry> entries() const;
+
+  /**
+   * Returns the latency of the last reload.
+   *
+   * Measured from the first write seen in a burst to the moment the new
+   * entries were ready, so it includes the debounce interval.
+   */
+  std::chrono::microseconds lastReloadLatency() const;
+
+private:
+  // A watched file, keyed in `files_` by its case-folded path.
+  struct WatchedFile {
+    std::filesystem::path path;
+    std::wstring directoryKey;
+    std::vector<parser::EnumEntry> entries;
+  };
+
+  void run(std::vector<std::filesystem::path> directories);
+  void reload(const std::vector<std::filesystem::path> &paths,
+              std::chrono::steady_clock::time_point observedAt);
+  std::vector<parser::EnumEntry> collectEntries() const;
+
+  std::chrono::milliseconds debounce_;
+  std::map<std::wstring, WatchedFile> files_;
+  std::map<u32, Callback> subscribers_;
+  u32 nextHandle_;
+  mutable std::mutex mutex_;
+  std::thread thread_;
+  void *stopEvent_;
+  std::atomic<i64> lastLatency_;
+};
+
+} // namespace winplus::compiler::watch
+
+#endif
@@ -1,4 +1,6 @@
 #include "Winplus_error.hpp"
+#include "Winplus_geometry.hpp"
+#include "Winplus_notify.hpp"
 #include "Winplus_rand.hpp"
 #include "Winplus_types.hpp"
 #include "Winplus_user.hpp"
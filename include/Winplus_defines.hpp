@@ -6,7 +6,12 @@ namespace winplus {
 // oh my god (。>︿<)_θ
 // I forgot this library only supports windows
 // just take out of the memory the thing I've just done.. (┬┬﹏┬┬)
+#ifdef _WIN32
 #define WINPLUS_API __declspec(dllexport)
+#else
+// Headless parts such as the notification queue also build elsewhere.
+#define WINPLUS_API __attribute__((visibility("default")))
+#endif
 
 } // namespace winplus
 
@@ -1,9 +1,17 @@
 #include "Winplus_defines.hpp"
 #include "Winplus_types.hpp"
+#include <format>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
 
 #ifndef WINPLUS_ERROR_H
 #define WINPLUS_ERROR_H
 
+namespace winplus::compiler::parser {
+struct EnumEntry;
+} // namespace winplus::compiler::parser
+
 namespace winplus::error {
 /**
  * Terminates the current process with an error code.
@@ -22,6 +30,105 @@ WINPLUS_API void StopProcess(winplus::error_code code, const string message);
  * termination. Does not halt execution of the program.
  */
 WINPLUS_API void Log(winplus::error_code code, const string message);
+
+/**
+ * Error messages indexed by error code.
+ *
+ * Built from compiled conf entries: every entry of type 'error' maps its
+ * enumeration number to its title. The title may contain `std::format`
+ * placeholders that are filled in by `Log(code, args...)`.
+ */
+class WINPLUS_API ErrorCatalog {
+public:
+  ErrorCatalog() = default;
+
+  /** Builds the catalog from the 'error' entries of a compiled conf. */
+  explicit ErrorCatalog(
+      std::span<const compiler::parser::EnumEntry> entries);
+
+  /**
+   * Returns the message of an error code.
+   *
+   * Returns nullptr if the catalog has no message for the code.
+   */
+  const string *Find(winplus::error_code code) const;
+
+  /** Returns the number of messages in the catalog. */
+  sz Size() const { return messages_.size(); }
+
+private:
+  std::unordered_map<winplus::error_code, string> messages_;
+};
+
+/**
+ * Sets the catalog used by the code-only `Log` and `StopProcess` overloads.
+ *
+ * The catalog is not copied and must outlive its use; pass nullptr to remove
+ * it. Codes without a catalog message are logged as unknown errors.
+ */
+WINPLUS_API void SetCatalog(const ErrorCatalog *catalog);
+
+/**
+ * Logs an error code with its message from the catalog.
+ *
+ * Looks the message up in the catalog set with `SetCatalog`, so reporting an
+ * error builds no string.
+ */
+WINPLUS_API void Log(winplus::error_code code);
+
+/**
+ * Logs an error code with its catalog message formatted with arguments.
+ *
+ * The catalog message is used as a format string, and formatting is
+ * deferred until output. Used by the variadic `Log` overload.
+ */
+WINPLUS_API void LogFormat(winplus::error_code code, std::format_args args);
+
+/**
+ * Terminates the current process with an error code from the catalog.
+ *
+ * Like `StopProcess(code, message)`, but takes the message from the catalog
+ * set with `SetCatalog`.
+ */
+WINPLUS_API void StopProcess(winplus::error_code code);
+
+/**
+ * Terminates the current process with an error code from the catalog, its
+ * message formatted with arguments.
+ */
+WINPLUS_API void StopProcessFormat(winplus::error_code code,
+                                   std::format_args args);
+
+/**
+ * Whether `Args` are format arguments rather than a single message.
+ *
+ * A lone argument that converts to a string is the message of the existing
+ * `Log(code, message)` overload.
+ */
+template <typename... Args>
+concept FormatArgs =
+    sizeof...(Args) > 0 &&
+    !(sizeof...(Args) == 1 && (std::is_convertible_v<const Args &, string> &&
+                               ...));
+
+/**
+ * Logs an error code with its catalog message formatted with `args`.
+ */
+template <typename... Args>
+  requires FormatArgs<Args...>
+void Log(winplus::error_code code, const Args &...args) {
+  LogFormat(code, std::make_format_args(args...));
+}
+
+/**
+ * Terminates the current process with an error code and its catalog message
+ * formatted with `args`.
+ */
+template <typename... Args>
+  requires FormatArgs<Args...>
+void StopProcess(winplus::error_code code, const Args &...args) {
+  StopProcessFormat(code, std::make_format_args(args...));
+}
 } // namespace winplus::error
 
 #endif
\ No newline at end of file
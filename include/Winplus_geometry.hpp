@@ -0,0 +1,128 @@
+#include "Winplus_defines.hpp"
+#include "Winplus_types.hpp"
+#include <span>
+#include <vector>
+
+#ifndef WINPLUS_GEOMETRY_H
+#define WINPLUS_GEOMETRY_H
+
+namespace winplus::user {
+
+class WindowPlus;
+
+/**
+ * Structure representing a window rectangle.
+ *
+ * Holds the position and size of a window in pixels, in the same types as
+ * `WinPosPlus` and `WinSizePlus`.
+ */
+struct GeoRect {
+  i16 X;      /**< X-coordinate of the top left corner */
+  i16 Y;      /**< Y-coordinate of the top left corner */
+  u16 Width;  /**< Width in pixels */
+  u16 Height; /**< Height in pixels */
+};
+
+/**
+ * Geometry of many windows stored as structure of arrays.
+ *
+ * Keeps the positions and sizes of all windows in separate contiguous arrays
+ * so layout operations and hit tests run as SIMD kernels over every window at
+ * once. Windows are referred to by index; a higher index is drawn on top.
+ * `Load` and `Store` copy the geometry from and back to `WindowPlus` objects.
+ */
+class WINPLUS_API WindowGeometry {
+public:
+  /** Returned by `HitTest` when no window contains the point. */
+  static constexpr sz NoWindow = static_cast<sz>(-1);
+
+  /** Adds a window and returns its index. */
+  sz Add(const GeoRect &rect);
+
+  /** Returns the geometry of the window at the given index. */
+  GeoRect Get(sz index) const;
+
+  /** Sets the geometry of the window at the given index. */
+  void Set(sz index, const GeoRect &rect);
+
+  /** Returns the number of windows. */
+  sz Size() const { return posX_.size(); }
+
+  /** Reserves storage for the given number of windows. */
+  void Reserve(sz count);
+
+  /** Removes all windows. */
+  void Clear();
+
+  /**
+   * Replaces the geometry with the one of the given windows.
+   *
+   * Window `i` of the span becomes index `i`.
+   */
+  void Load(std::span<const WindowPlus> windows);
+
+  /**
+   * Writes the geometry back to the given windows.
+   *
+   * Index `i` is written to window `i` of the span; the span must not be
+   * longer than `Size()`, and windows past `Size()` are left unchanged.
+   */
+  void Store(std::span<WindowPlus> windows) const;
+
+  /**
+   * Moves every window by the given offset.
+   *
+   * Positions saturate at the limits of i16 instead of wrapping around.
+   */
+  void MoveBy(i16 dx, i16 dy);
+
+  /**
+   * Moves and shrinks every window to fit on the screen.
+   *
+   * Windows larger than the screen are shrunk to its size, then moved so
+   * they lie completely within `[0, screenWidth) x [0, screenHeight)`. Screen
+   * sizes above the i16 range are treated as 32767.
+   */
+  void ClampToScreen(u16 screenWidth, u16 screenHeight);
+
+  /**
+   * Arranges all windows in a grid covering the screen.
+   *
+   * Uses the given number of columns, or the smallest square grid that fits
+   * every window when `columns` is zero. All windows get the size of one
+   * grid cell.
+   */
+  void Tile(u16 screenWidth, u16 screenHeight, u16 columns = 0);
+
+  /**
+   * Arranges all windows diagonally, each offset by `step` from the previous.
+   *
+   * The offset wraps back to the origin before it reaches the middle of the
+   * screen. Sizes are left unchanged.
+   */
+  void Cascade(u16 step, u16 screenWidth, u16 screenHeight);
+
+  /**
+   * Returns the index of the topmost window containing the point.
+   *
+   * Returns `NoWindow` if no window contains it.
+   */
+  sz HitTest(i16 x, i16 y) const;
+
+  /**
+   * Collects the indices of all windows overlapping the rectangle.
+   *
+   * Indices are appended to `out` in ascending order.
+   */
+  void HitTest(const GeoRect &rect, std::vector<sz> &out) const;
+
+private:
+  std::vector<i16> posX_;
+  std::vector<i16> posY_;
+  std::vector<u16> width_;
+  std::vector<u16> height_;
+};
+
+} // namespace winplus::user
+
+#endif
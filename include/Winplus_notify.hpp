@@ -0,0 +1,158 @@
+#include "Winplus_defines.hpp"
+#include "Winplus_types.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef WINPLUS_NOTIFY_H
+#define WINPLUS_NOTIFY_H
+
+namespace winplus::user {
+
+/**
+ * A message box waiting to be shown.
+ *
+ * Mirrors the fields of `WinMessageBoxPlus`. `Count` is the number of
+ * identical notifications that were coalesced into this one.
+ */
+struct Notification {
+  string Title;     /**< Message box title. */
+  string ClassName; /**< Message box class name. */
+  u32 Type;         /**< Message box type, a `WMB_Type` value. */
+  u32 Count;        /**< Number of coalesced notifications. */
+};
+
+/**
+ * Displays notifications taken from a `NotificationQueue`.
+ *
+ * `Show()` is called on the queue's worker thread, one notification at a
+ * time, and may block until the notification is dismissed.
+ */
+class WINPLUS_API NotificationBackend {
+public:
+  virtual ~NotificationBackend() = default;
+
+  /** Displays a notification. */
+  virtual void Show(const Notification &notification) = 0;
+};
+
+/**
+ * Backend that shows notifications as modal message boxes.
+ *
+ * Blocks the queue's worker thread until the user dismisses each box, the
+ * calling threads are never blocked.
+ */
+class WINPLUS_API MessageBoxBackend : public NotificationBackend {
+public:
+  void Show(const Notification &notification) override;
+};
+
+/**
+ * Backend that records notifications instead of showing them.
+ *
+ * Useful for tests and services running without a desktop.
+ */
+class WINPLUS_API HeadlessBackend : public NotificationBackend {
+public:
+  void Show(const Notification &notification) override;
+
+  /** Returns every notification that would have been shown, in order. */
+  std::vector<Notification> Shown() const;
+
+private:
+  mutable std::mutex mutex_;
+  std::vector<Notification> shown_;
+};
+
+/**
+ * What a full notification queue does with a new notification.
+ */
+enum NQ_DropPolicy {
+  NQ_DROP_NEWEST, /**< Discard the new notification */
+  NQ_DROP_OLDEST  /**< Discard the oldest pending notification */
+};
+
+/**
+ * Counters of a notification queue.
+ */
+struct NotificationStats {
+  u64 Posted;    /**< Notifications passed to `Post()`. */
+  u64 Coalesced; /**< Notifications merged into a pending one. */
+  u64 Dropped;   /**< Notifications discarded because the queue was full. */
+  u64 Shown;     /**< Notifications handed to the backend. */
+};
+
+/**
+ * Asynchronous, coalescing queue of message boxes.
+ *
+ * `Post()` never blocks: notifications are shown one at a time by a worker
+ * thread. A notification with the same title and type as a pending one is
+ * merged into it by incrementing its count. After a notification is shown,
+ * the next identical one is held back until the coalescing window has
+ * passed, so an error storm produces one box per window instead of one per
+ * error. The queue holds at most `capacity` pending notifications.
+ */
+class WINPLUS_API NotificationQueue {
+public:
+  NotificationQueue(
+      NotificationBackend &backend, sz capacity = 64,
+      std::chrono::milliseconds window = std::chrono::milliseconds(1000),
+      NQ_DropPolicy policy = NQ_DROP_NEWEST);
+
+  /**
+   * Stops the worker thread.
+   *
+   * Waits for the notification currently being shown; pending notifications
+   * are discarded.
+   */
+  ~NotificationQueue();
+
+  NotificationQueue(const NotificationQueue &) = delete;
+  NotificationQueue &operator=(const NotificationQueue &) = delete;
+
+  /**
+   * Queues a message box without waiting for it to be shown.
+   *
+   * Returns false if the notification was dropped because the queue was full.
+   */
+  bool Post(string title, string className, u32 type);
+
+  /** Blocks until every pending notification has been shown. */
+  void Flush();
+
+  /** Returns the counters of the queue. */
+  NotificationStats Stats() const;
+
+private:
+  struct Pending {
+    Notification notification;
+    std::chrono::steady_clock::time_point notBefore;
+  };
+
+  void Run();
+
+  NotificationBackend &backend_;
+  sz capacity_;
+  std::chrono::milliseconds window_;
+  NQ_DropPolicy policy_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  std::deque<Pending> pending_;
+  std::map<std::pair<string, u32>, std::chrono::steady_clock::time_point>
+      lastShown_;
+  NotificationStats stats_;
+  bool showing_;
+  bool stopping_;
+  std::thread worker_;
+};
+
+} // namespace winplus::user
+
+#endif
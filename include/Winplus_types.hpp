@@ -1,6 +1,7 @@
 /*
   The header provides types with detailed description and examples.
 */
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -1,4 +1,5 @@
 #include "Winplus_defines.hpp"
+#include "Winplus_notify.hpp"
 #include "Winplus_types.hpp"
 #include <complex.h>
 #include <minwindef.h>
@@ -94,6 +95,15 @@ public:
    */
   WINPLUS_API void Open();
 
+  /**
+   * Queues a message box without blocking.
+   *
+   * Hands the message box to the given notification queue, which shows it on
+   * its worker thread and coalesces repeats. Returns false if the queue was
+   * full and dropped it.
+   */
+  WINPLUS_API bool Post(NotificationQueue &queue) const;
+
   /**
    * Sets the type and style of a message box.
    *
@@ -1,9 +1,38 @@
 #include "../include/Winplus.conf_compiler.hpp"
 #include <cctype>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 
 namespace winplus::compiler {
 namespace lexer {
 
+SourceMap::SourceMap(std::string_view source,
+                     std::pmr::memory_resource *resource)
+    : lineStarts_(resource) {
+  lineStarts_.push_back(0);
+
+  const char *begin = source.data();
+  const char *end = begin + source.size();
+  const char *cursor = begin;
+  while (cursor < end) {
+    cursor = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+    if (cursor == nullptr)
+      break;
+    cursor++;
+    lineStarts_.push_back(static_cast<u32>(cursor - begin));
+  }
+}
+
+SourceLocation SourceMap::locate(u32 offset) const {
+  auto it = std::upper_bound(lineStarts_.begin(), lineStarts_.end(), offset);
+  u32 line = static_cast<u32>(it - lineStarts_.begin());
+  return SourceLocation{line, offset - *(it - 1) + 1};
+}
+
 char Lexer::advance() { return source_[current_++]; }
 
 char Lexer::peek() const {
@@ -34,10 +63,7 @@ void Lexer::skipWhitespace() {
     case ' ':
     case '\r':
     case '\t':
-      advance();
-      break;
     case '\n':
-      line_++;
       advance();
       break;
     default:
@@ -47,16 +73,13 @@ void Lexer::skipWhitespace() {
 }
 
 Lexer::Token Lexer::makeToken(TokenType type) {
-  std::string lexeme = source_.substr(start_, current_ - start_);
-  return Token(type, lexeme, line_);
+  return Token(type, static_cast<u32>(start_),
+               static_cast<u32>(current_ - start_));
 }
 
 Lexer::Token Lexer::string() {
-  while (peek() != '\'' && !source_.empty()) {
-    if (peek() == '\n')
-      line_++;
+  while (peek() != '\'' && current_ < source_.length())
     advance();
-  }
 
   if (current_ >= source_.length()) {
     return errorToken("Unterminated string.");
@@ -64,34 +87,68 @@ Lexer::Token Lexer::string() {
 
   advance();
 
-  std::string value = source_.substr(start_ + 1, current_ - start_ - 2);
-  return Token(TokenType::STRING_LITERAL, value, line_);
+  return makeToken(TokenType::STRING_LITERAL);
 }
 
 Lexer::Token Lexer::number() {
-  while (isDigit(peek()))
+  int base = 10;
+  size_t digits = start_;
+  if (source_[start_] == '0') {
+    switch (peek()) {
+    case 'x':
+    case 'X':
+      base = 16;
+      break;
+    case 'o':
+    case 'O':
+      base = 8;
+      break;
+    case 'b':
+    case 'B':
+      base = 2;
+      break;
+    }
+    if (base != 10) {
+      advance();
+      digits = current_;
+    }
+  }
+
+  while (isAlphaNumeric(peek()))
     advance();
 
-  std::string num = source_.substr(start_, current_ - start_);
-  return Token(TokenType::INT_LITERAL, num, line_);
+  std::string_view num(source_.data() + start_, current_ - start_);
+
+  const char *first = source_.data() + digits;
+  const char *last = source_.data() + current_;
+  u64 value = 0;
+  auto [ptr, ec] = std::from_chars(first, last, value, base);
+
+  if (ec == std::errc::result_out_of_range)
+    return errorToken("Integer literal out of range: " + std::string(num));
+  if (first == last || ec != std::errc() || ptr != last)
+    return errorToken("Invalid integer literal: " + std::string(num));
+
+  return Token(TokenType::INT_LITERAL, static_cast<u32>(start_),
+               static_cast<u32>(current_ - start_), value);
 }
 
 Lexer::Token Lexer::identifier() {
   while (isAlphaNumeric(peek()))
     advance();
 
-  std::string text = source_.substr(start_, current_ - start_);
+  std::string_view text(source_.data() + start_, current_ - start_);
 
   if (text == "enumeration")
-    return Token(TokenType::ENUMERATION, text, line_);
+    return makeToken(TokenType::ENUMERATION);
   if (text == "type")
-    return Token(TokenType::TYPE, text, line_);
+    return makeToken(TokenType::TYPE);
   if (text == "title")
-    return Token(TokenType::TITLE, text, line_);
+    return makeToken(TokenType::TITLE);
   if (text == "id")
-    return Token(TokenType::ID, text, line_);
+    return makeToken(TokenType::ID);
 
-  return errorToken("Unexpected identifier: " + text);
+  return errorToken("Unexpected identifier: " + std::string(text));
 }
 
 bool Lexer::isDigit(char c) const { return c >= '0' && c <= '9'; }
@@ -102,8 +159,10 @@ bool Lexer::isAlpha(char c) const {
 
 bool Lexer::isAlphaNumeric(char c) const { return isAlpha(c) || isDigit(c); }
 
-Lexer::Token Lexer::errorToken(const std::string &message) {
-  return Token(TokenType::ERROR, message, line_);
+Lexer::Token Lexer::errorToken(std::string_view message) {
+  messages_.emplace_back(message);
+  return Token(TokenType::ERROR, static_cast<u32>(start_),
+               static_cast<u32>(current_ - start_), messages_.size() - 1);
 }
 
 Lexer::Token Lexer::nextToken() {
@@ -112,7 +171,7 @@ Lexer::Token Lexer::nextToken() {
   start_ = current_;
 
   if (current_ >= source_.length()) {
-    return Token(TokenType::END_OF_FILE, "", line_);
+    return makeToken(TokenType::END_OF_FILE);
   }
 
   char c = advance();
@@ -134,15 +193,31 @@ Lexer::Token Lexer::nextToken() {
   return errorToken(std::string("Unexpected character: ") + c);
 }
 
-std::vector<lexer::Lexer::Token> Lexer::tokenize() {
-  std::vector<Token> tokens;
+std::string_view Lexer::lexeme(const Token &token) const {
+  std::string_view text(source_.data() + token.offset, token.length);
+  if (token.type == TokenType::STRING_LITERAL)
+    return text.substr(1, text.size() - 2);
+  return text;
+}
+
+std::string_view Lexer::message(const Token &token) const {
+  return messages_[token.value];
+}
+
+SourceLocation Lexer::location(u32 offset) const {
+  if (!sourceMap_)
+    sourceMap_.emplace(source_, resource_);
+  return sourceMap_->locate(offset);
+}
+
+std::pmr::vector<lexer::Lexer::Token> Lexer::tokenize() {
+  std::pmr::vector<Token> tokens(resource_);
 
   while (hasMoreTokens()) {
-    Token token = nextToken();
-    tokens.push_back(token);
+    tokens.push_back(nextToken());
 
-    if (token.type == TokenType::ERROR ||
-        token.type == TokenType::END_OF_FILE) {
+    if (tokens.back().type == TokenType::ERROR ||
+        tokens.back().type == TokenType::END_OF_FILE) {
       break;
     }
   }
@@ -154,12 +229,12 @@ std::vector<lexer::Lexer::Token> Lexer::tokenize() {
 
 namespace parser {
 
-lexer::Lexer::Token Parser::peek() const {
+const lexer::Lexer::Token &Parser::peek() const {
   if (isAtEnd()) return tokens_[tokens_.size() - 1];
   return tokens_[current_];
 }
 
-lexer::Lexer::Token Parser::advance() {
+const lexer::Lexer::Token &Parser::advance() {
   if (!isAtEnd()) current_++;
   return tokens_[current_ - 1];
 }
@@ -169,9 +244,13 @@ bool Parser::check(lexer::Lexer::TokenType type) const {
   return peek().type == type;
 }
 
-lexer::Lexer::Token Parser::consume(lexer::Lexer::TokenType type, const std::string& message) {
+const lexer::Lexer::Token &Parser::consume(lexer::Lexer::TokenType type, const std::string& message) {
   if (check(type)) return advance();
-  throw std::runtime_error(message);
+
+  const auto &token = peek();
+  if (token.type == lexer::Lexer::TokenType::ERROR)
+    throw ParseError(std::string(lexer_.message(token)), token.offset);
+  throw ParseError(message, token.offset);
 }
 
 bool Parser::isAtEnd() const {
@@ -179,37 +258,53 @@ bool Parser::isAtEnd() const {
          tokens_[current_].type == lexer::Lexer::TokenType::END_OF_FILE;
 }
 
-EnumEntry Parser::parseEnumeration() {
+u64 Parser::checkRange(const lexer::Lexer::Token &token, u64 max,
+                       const std::string &message) const {
+  if (token.value > max)
+    throw ParseError(message + ": " + std::string(lexer_.lexeme(token)),
+                     token.offset);
+  return token.value;
+}
+
+void Parser::report(u32 offset, const std::string &message) {
+  diagnostics_.push_back(Diagnostic{offset, lexer_.location(offset), message});
+}
+
+EnumEntry Parser::parseEnumeration(EntryOffsets &offsets) {
   EnumEntry entry;
   
   // Parse: enumeration [number]:
   consume(lexer::Lexer::TokenType::ENUMERATION, "Expected 'enumeration'");
-  auto enumIdToken = consume(lexer::Lexer::TokenType::INT_LITERAL, "Expected enumeration ID");
-  entry.enumId = std::stoi(enumIdToken.lexeme);
+  const auto &enumIdToken = consume(lexer::Lexer::TokenType::INT_LITERAL, "Expected enumeration ID");
+  entry.enumId = static_cast<u16>(checkRange(
+      enumIdToken, UINT16_MAX, "Enumeration ID out of range"));
+  offsets.enumId = enumIdToken.offset;
   consume(lexer::Lexer::TokenType::COLON, "Expected ':' after enumeration ID");
 
   // Parse: type: '[value]'
   consume(lexer::Lexer::TokenType::TYPE, "Expected 'type'");
   consume(lexer::Lexer::TokenType::COLON, "Expected ':' after 'type'");
-  auto typeToken = consume(lexer::Lexer::TokenType::STRING_LITERAL, "Expected type value");
-  entry.type = typeToken.lexeme;
+  const auto &typeToken = consume(lexer::Lexer::TokenType::STRING_LITERAL, "Expected type value");
+  entry.type = lexer_.lexeme(typeToken);
 
   // Validate type value
   if (entry.type != "error" && entry.type != "app_id") {
-    throw std::runtime_error("Invalid type value: '" + entry.type + "'. Expected 'error' or 'app_id'");
+    throw ParseError("Invalid type value: '" + entry.type + "'. Expected 'error' or 'app_id'", typeToken.offset);
   }
 
   // Parse: title: '[value]'
   consume(lexer::Lexer::TokenType::TITLE, "Expected 'title'");
   consume(lexer::Lexer::TokenType::COLON, "Expected ':' after 'title'");
-  auto titleToken = consume(lexer::Lexer::TokenType::STRING_LITERAL, "Expected title value");
-  entry.title = titleToken.lexeme;
+  const auto &titleToken = consume(lexer::Lexer::TokenType::STRING_LITERAL, "Expected title value");
+  entry.title = lexer_.lexeme(titleToken);
 
   // Parse: id: [number];
   consume(lexer::Lexer::TokenType::ID, "Expected 'id'");
   consume(lexer::Lexer::TokenType::COLON, "Expected ':' after 'id'");
-  auto idToken = consume(lexer::Lexer::TokenType::INT_LITERAL, "Expected ID value");
-  entry.id = std::stoi(idToken.lexeme);
+  const auto &idToken = consume(lexer::Lexer::TokenType::INT_LITERAL, "Expected ID value");
+  entry.id = static_cast<u32>(
+      checkRange(idToken, UINT32_MAX, "ID value out of range"));
+  offsets.id = idToken.offset;
   consume(lexer::Lexer::TokenType::SEMICOLON, "Expected ';' after enumeration");
 
   return entry;
@@ -220,8 +315,12 @@ std::vector<EnumEntry> Parser::parse() {
   
   while (!isAtEnd()) {
     try {
-      entries.push_back(parseEnumeration());
-    } catch (const std::runtime_error& e) {
+      EntryOffsets offsets;
+      entries.push_back(parseEnumeration(offsets));
+      offsets_.push_back(offsets);
+    } catch (const ParseError& e) {
+      report(e.offset(), e.what());
+
       // Skip to the next enumeration or end of file
       while (!isAtEnd() && !check(lexer::Lexer::TokenType::ENUMERATION)) {
         advance();
@@ -233,4 +332,31 @@ std::vector<EnumEntry> Parser::parse() {
 }
 
 } // namespace parser
+
+std::vector<parser::EnumEntry>
+Compile(std::string_view source, std::pmr::memory_resource *resource,
+        std::vector<parser::Diagnostic> *diagnostics) {
+  lexer::Lexer lexer(source, resource);
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens, lexer);
+  auto entries = parser.parse();
+  if (diagnostics != nullptr)
+    diagnostics->insert(diagnostics->end(), parser.diagnostics().begin(),
+                        parser.diagnostics().end());
+  return entries;
+}
+
+std::vector<parser::EnumEntry>
+CompileFile(const std::filesystem::path &path,
+            std::pmr::memory_resource *resource,
+            std::vector<parser::Diagnostic> *diagnostics) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+    throw std::runtime_error("Failed to open the file: " + path.string());
+
+  std::ostringstream content;
+  content << file.rdbuf();
+  return Compile(content.view(), resource, diagnostics);
+}
+
 } // namespace winplus::compiler
@@ -0,0 +1,115 @@
+#include "../include/Winplus.conf_memory.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace winplus::compiler::memory {
+
+namespace {
+
+// Counts the heap block of a string that outgrew its inline buffer.
+void countString(const std::string &string, AllocationStats &stats) {
+  std::less<const void *> less;
+  const void *begin = &string;
+  const void *end = &string + 1;
+  if (!less(string.data(), begin) && less(string.data(), end))
+    return;
+  stats.bytes += string.capacity() + 1;
+  stats.allocations++;
+}
+
+template <typename T>
+void countVector(const std::vector<T> &vector, AllocationStats &stats) {
+  if (vector.capacity() == 0)
+    return;
+  stats.bytes += vector.capacity() * sizeof(T);
+  stats.allocations++;
+}
+
+} // namespace
+
+void CountingResource::beginPhase(std::string name) {
+  phases_.push_back(PhaseStats{std::move(name), {}});
+  phases_.back().stats.peak = live_;
+}
+
+void CountingResource::reset() {
+  total_ = {};
+  total_.peak = live_;
+  phases_.clear();
+}
+
+void *CountingResource::do_allocate(sz bytes, sz alignment) {
+  void *p = upstream_->allocate(bytes, alignment);
+
+  live_ += bytes;
+  total_.bytes += bytes;
+  total_.allocations++;
+  total_.peak = std::max(total_.peak, live_);
+
+  if (!phases_.empty()) {
+    AllocationStats &phase = phases_.back().stats;
+    phase.bytes += bytes;
+    phase.allocations++;
+    phase.peak = std::max(phase.peak, live_);
+  }
+
+  return p;
+}
+
+void CountingResource::do_deallocate(void *p, sz bytes, sz alignment) {
+  upstream_->deallocate(p, bytes, alignment);
+
+  live_ -= bytes;
+  total_.deallocations++;
+  if (!phases_.empty())
+    phases_.back().stats.deallocations++;
+}
+
+bool CountingResource::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
+
+CompileReport CompileInArena(std::string_view source, sz initialSize) {
+  CountingResource heap(std::pmr::new_delete_resource());
+
+  CompileReport report;
+  {
+    std::pmr::monotonic_buffer_resource arena(initialSize, &heap);
+    CountingResource counting(&arena);
+
+    counting.beginPhase("source");
+    lexer::Lexer lexer(source, &counting);
+
+    counting.beginPhase("lex");
+    auto tokens = lexer.tokenize();
+
+    counting.beginPhase("parse");
+    parser::Parser parser(tokens, lexer);
+    report.entries = parser.parse();
+    report.diagnostics = parser.diagnostics();
+    report.locations.reserve(parser.offsets().size());
+    for (const auto &offsets : parser.offsets())
+      report.locations.push_back(EntryLocation{lexer.location(offsets.enumId),
+                                               lexer.location(offsets.id)});
+
+    report.total = counting.stats();
+    report.phases = counting.phases();
+  }
+
+  report.arena = heap.stats();
+
+  countVector(report.entries, report.output);
+  for (const auto &entry : report.entries) {
+    countString(entry.type, report.output);
+    countString(entry.title, report.output);
+  }
+  countVector(report.locations, report.output);
+  countVector(report.diagnostics, report.output);
+  for (const auto &diagnostic : report.diagnostics)
+    countString(diagnostic.message, report.output);
+  report.output.peak = report.output.bytes;
+  return report;
+}
+
+} // namespace winplus::compiler::memory
@@ -0,0 +1,185 @@
+#include "../include/Winplus.conf_shared.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <windows.h>
+
+namespace winplus::compiler::shared {
+
+namespace {
+
+std::string segmentName(const std::string &name, u64 version) {
+  return name + "." + std::to_string(version);
+}
+
+} // namespace
+
+SharedTablePublisher::SharedTablePublisher(std::string name)
+    : name_(std::move(name)), controlMapping_(NULL), control_(nullptr),
+      tableMapping_(NULL) {
+  controlMapping_ =
+      CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0,
+                         sizeof(SharedControl), name_.c_str());
+  if (controlMapping_ == NULL)
+    throw std::runtime_error("Failed to create shared segment: " + name_);
+
+  control_ = static_cast<SharedControl *>(MapViewOfFile(
+      controlMapping_, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0,
+      sizeof(SharedControl)));
+  if (control_ == nullptr) {
+    CloseHandle(controlMapping_);
+    throw std::runtime_error("Failed to map shared segment: " + name_);
+  }
+
+  // A new segment is zero filled. An existing one was left by a publisher
+  // that withdrew its version or crashed; versions whose segments readers
+  // still map are skipped by `publish()`.
+  control_->magic = SHARED_MAGIC;
+}
+
+SharedTablePublisher::~SharedTablePublisher() {
+  // The current segment dies with the last handle, so stop advertising it.
+  control_->version.store(0, std::memory_order_release);
+  if (tableMapping_ != NULL)
+    CloseHandle(tableMapping_);
+  UnmapViewOfFile(control_);
+  CloseHandle(controlMapping_);
+}
+
+u64 SharedTablePublisher::publish(std::span<const parser::EnumEntry> entries) {
+  u64 version = control_->version.load();
+  std::string name;
+  HANDLE mapping;
+  std::vector<char> bytes;
+  for (;;) {
+    version++;
+    bytes = table::BuildTable(entries, version);
+    name = segmentName(name_, version);
+    mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                 static_cast<DWORD>(u64(bytes.size()) >> 32),
+                                 static_cast<DWORD>(bytes.size()),
+                                 name.c_str());
+    if (mapping == NULL)
+      throw std::runtime_error("Failed to create shared segment: " + name);
+
+    // A segment of this version is still alive, left by a publisher that
+    // stopped before storing its version; readers may map it, so never write
+    // into it and skip the version instead.
+    if (GetLastError() != ERROR_ALREADY_EXISTS)
+      break;
+    CloseHandle(mapping);
+  }
+
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0,
+                             bytes.size());
+  if (view == nullptr) {
+    CloseHandle(mapping);
+    throw std::runtime_error("Failed to map shared segment: " + name);
+  }
+  std::memcpy(view, bytes.data(), bytes.size());
+  UnmapViewOfFile(view);
+
+  control_->version.store(version, std::memory_order_release);
+
+  // Readers that mapped the previous version keep it alive on their own.
+  if (tableMapping_ != NULL)
+    CloseHandle(tableMapping_);
+  tableMapping_ = mapping;
+  return version;
+}
+
+SharedTableReader::SharedTableReader(std::string name)
+    : name_(std::move(name)), controlMapping_(NULL), control_(nullptr),
+      tableMapping_(NULL), tableView_(nullptr) {
+  controlMapping_ = OpenFileMappingA(FILE_MAP_READ, FALSE, name_.c_str());
+  if (controlMapping_ == NULL)
+    throw std::runtime_error("No shared table published as: " + name_);
+
+  control_ = static_cast<const SharedControl *>(
+      MapViewOfFile(controlMapping_, FILE_MAP_READ, 0, 0,
+                    sizeof(SharedControl)));
+  if (control_ == nullptr || control_->magic != SHARED_MAGIC) {
+    if (control_ != nullptr)
+      UnmapViewOfFile(control_);
+    CloseHandle(controlMapping_);
+    throw std::runtime_error("No shared table published as: " + name_);
+  }
+
+  if (!refresh()) {
+    unmap();
+    UnmapViewOfFile(control_);
+    CloseHandle(controlMapping_);
+    throw std::runtime_error("No shared table published as: " + name_);
+  }
+}
+
+SharedTableReader::~SharedTableReader() {
+  unmap();
+  UnmapViewOfFile(control_);
+  CloseHandle(controlMapping_);
+}
+
+bool SharedTableReader::refresh() {
+  // The publisher may replace the version we just read before we open its
+  // segment; read the control block again until a mapping succeeds.
+  for (;;) {
+    u64 version = control_->version.load(std::memory_order_acquire);
+    if (version == 0)
+      return false;
+    if (tableView_ != nullptr && version == table_.version())
+      return false;
+    if (map(version))
+      return true;
+    if (control_->version.load(std::memory_order_acquire) == version)
+      return false;
+  }
+}
+
+bool SharedTableReader::map(u64 version) {
+  std::string name = segmentName(name_, version);
+  HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+  if (mapping == NULL)
+    return false;
+
+  const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    CloseHandle(mapping);
+    return false;
+  }
+
+  // The header comes from another process, so bound the view by the size of
+  // the mapped region rather than trusting its `totalSize`.
+  MEMORY_BASIC_INFORMATION region;
+  if (VirtualQuery(view, &region, sizeof(region)) == 0) {
+    UnmapViewOfFile(view);
+    CloseHandle(mapping);
+    return false;
+  }
+
+  table::TableView table;
+  try {
+    table = table::TableView(std::span<const char>(
+        static_cast<const char *>(view), region.RegionSize));
+  } catch (const std::runtime_error &e) {
+    UnmapViewOfFile(view);
+    CloseHandle(mapping);
+    return false;
+  }
+
+  unmap();
+  tableMapping_ = mapping;
+  tableView_ = view;
+  table_ = table;
+  return true;
+}
+
+void SharedTableReader::unmap() {
+  table_ = table::TableView();
+  if (tableView_ != nullptr)
+    UnmapViewOfFile(tableView_);
+  if (tableMapping_ != NULL)
+    CloseHandle(tableMapping_);
+  tableView_ = nullptr;
+  tableMapping_ = NULL;
+}
+
+} // namespace winplus::compiler::shared
@@ -0,0 +1,106 @@
+#include "../include/Winplus.conf_snapshot.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace winplus::compiler::snapshot {
+
+ConfSnapshot::ConfSnapshot(std::vector<parser::EnumEntry> entries, u64 version)
+    : entries_(std::move(entries)), version_(version) {
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const parser::EnumEntry &a, const parser::EnumEntry &b) {
+                     return a.enumId < b.enumId;
+                   });
+
+  byId_.resize(entries_.size());
+  for (u32 i = 0; i < byId_.size(); i++)
+    byId_[i] = i;
+  std::stable_sort(byId_.begin(), byId_.end(), [this](u32 a, u32 b) {
+    return entries_[a].id < entries_[b].id;
+  });
+}
+
+const parser::EnumEntry *ConfSnapshot::findByEnumId(u16 enumId) const {
+  auto it = std::lower_bound(
+      entries_.begin(), entries_.end(), enumId,
+      [](const parser::EnumEntry &entry, u16 value) {
+        return entry.enumId < value;
+      });
+  if (it == entries_.end() || it->enumId != enumId)
+    return nullptr;
+  return &*it;
+}
+
+const parser::EnumEntry *ConfSnapshot::findById(u32 id) const {
+  auto it = std::lower_bound(byId_.begin(), byId_.end(), id,
+                             [this](u32 index, u32 value) {
+                               return entries_[index].id < value;
+                             });
+  if (it == byId_.end() || entries_[*it].id != id)
+    return nullptr;
+  return &entries_[*it];
+}
+
+namespace {
+
+// Spreads reader threads over the counters round robin.
+std::atomic<sz> nextReaderSlot = 0;
+
+} // namespace
+
+SnapshotStore::SnapshotStore()
+    : current_(new Pointer(std::make_shared<const ConfSnapshot>(
+          std::vector<parser::EnumEntry>(), 0))),
+      epoch_(0) {}
+
+SnapshotStore::~SnapshotStore() { delete current_.load(); }
+
+std::atomic<u64> &SnapshotStore::enter() const {
+  static thread_local const sz slot =
+      nextReaderSlot.fetch_add(1, std::memory_order_relaxed) % READER_SLOTS;
+
+  // The counter is raised before the pointer is loaded, so a writer that
+  // replaced the pointer and then sees the counter at zero knows this reader
+  // either left or loaded the new pointer.
+  std::atomic<u64> &active = readers_[slot].active[epoch_.load() & 1];
+  active.fetch_add(1);
+  return active;
+}
+
+SnapshotStore::ReadGuard SnapshotStore::read() const {
+  std::atomic<u64> &active = enter();
+  return ReadGuard(active, current_.load()->get());
+}
+
+std::shared_ptr<const ConfSnapshot> SnapshotStore::acquire() const {
+  std::atomic<u64> &active = enter();
+  Pointer snapshot = *current_.load();
+  active.fetch_sub(1, std::memory_order_release);
+  return snapshot;
+}
+
+u64 SnapshotStore::publish(std::vector<parser::EnumEntry> entries) {
+  // Writers are serialized so versions are published in order; readers are
+  // never blocked by this mutex.
+  std::lock_guard lock(publishMutex_);
+  u64 version = (*current_.load())->version() + 1;
+  const Pointer *previous = current_.exchange(new Pointer(
+      std::make_shared<const ConfSnapshot>(std::move(entries), version)));
+  synchronize();
+  delete previous;
+  return version;
+}
+
+void SnapshotStore::synchronize() {
+  // Flip the epoch twice and wait for the readers of the parity that was just
+  // left each time. New readers count against the other parity, so neither
+  // wait can be prolonged by readers arriving after the flip.
+  for (int phase = 0; phase < 2; phase++) {
+    u32 parity = epoch_.fetch_add(1) & 1;
+    for (auto &reader : readers_) {
+      while (reader.active[parity].load() != 0)
+        std::this_thread::yield();
+    }
+  }
+}
+
+} // namespace winplus::compiler::snapshot
@@ -0,0 +1,187 @@
+#include "../include/Winplus.conf_table.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace winplus::compiler::table {
+
+namespace {
+
+// Appends strings to the pool once and returns the offset of the first copy.
+class StringPool {
+public:
+  u32 intern(const std::string &value) {
+    auto it = offsets_.find(value);
+    if (it != offsets_.end())
+      return it->second;
+
+    u32 offset = static_cast<u32>(bytes_.size());
+    bytes_.insert(bytes_.end(), value.begin(), value.end());
+    offsets_.emplace(value, offset);
+    return offset;
+  }
+
+  const std::vector<char> &bytes() const { return bytes_; }
+
+private:
+  std::vector<char> bytes_;
+  std::map<std::string, u32> offsets_;
+};
+
+template <typename T> void append(std::vector<char> &out, const T &value) {
+  const char *bytes = reinterpret_cast<const char *>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void align(std::vector<char> &out, sz alignment) {
+  while (out.size() % alignment != 0)
+    out.push_back('\0');
+}
+
+} // namespace
+
+std::vector<char> BuildTable(std::span<const parser::EnumEntry> entries,
+                             u64 version) {
+  std::vector<const parser::EnumEntry *> sorted;
+  for (const auto &entry : entries)
+    sorted.push_back(&entry);
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const parser::EnumEntry *a, const parser::EnumEntry *b) {
+                     return a->enumId < b->enumId;
+                   });
+
+  std::vector<u32> idIndex(sorted.size());
+  for (u32 i = 0; i < idIndex.size(); i++)
+    idIndex[i] = i;
+  std::stable_sort(idIndex.begin(), idIndex.end(), [&](u32 a, u32 b) {
+    return sorted[a]->id < sorted[b]->id;
+  });
+
+  StringPool pool;
+  std::vector<TableEntry> records;
+  for (const auto *entry : sorted) {
+    TableEntry record = {};
+    record.id = entry->id;
+    record.enumId = entry->enumId;
+    record.typeOffset = pool.intern(entry->type);
+    record.typeLength = static_cast<u32>(entry->type.size());
+    record.titleOffset = pool.intern(entry->title);
+    record.titleLength = static_cast<u32>(entry->title.size());
+    records.push_back(record);
+  }
+
+  TableHeader header = {};
+  header.magic = TABLE_MAGIC;
+  header.format = TABLE_FORMAT;
+  header.version = version;
+  header.entryCount = static_cast<u32>(records.size());
+
+  std::vector<char> out;
+  append(out, header);
+
+  align(out, alignof(TableEntry));
+  header.entriesOffset = static_cast<u32>(out.size());
+  for (const auto &record : records)
+    append(out, record);
+
+  align(out, alignof(u32));
+  header.idIndexOffset = static_cast<u32>(out.size());
+  for (u32 index : idIndex)
+    append(out, index);
+
+  header.stringsOffset = static_cast<u32>(out.size());
+  header.stringsSize = static_cast<u32>(pool.bytes().size());
+  out.insert(out.end(), pool.bytes().begin(), pool.bytes().end());
+
+  header.totalSize = static_cast<u32>(out.size());
+  std::memcpy(out.data(), &header, sizeof(header));
+  return out;
+}
+
+TableView::TableView(std::span<const char> bytes) {
+  if (bytes.size() < sizeof(TableHeader))
+    throw std::runtime_error("Compiled table is truncated");
+
+  header_ = reinterpret_cast<const TableHeader *>(bytes.data());
+  if (header_->magic != TABLE_MAGIC)
+    throw std::runtime_error("Not a compiled table");
+  if (header_->format != TABLE_FORMAT)
+    throw std::runtime_error("Unsupported compiled table format");
+
+  u64 count = header_->entryCount;
+  if (header_->totalSize > bytes.size() ||
+      header_->entriesOffset + count * sizeof(TableEntry) >
+          header_->totalSize ||
+      header_->idIndexOffset + count * sizeof(u32) > header_->totalSize ||
+      u64(header_->stringsOffset) + header_->stringsSize > header_->totalSize)
+    throw std::runtime_error("Compiled table is truncated");
+
+  const char *base = bytes.data();
+  if (reinterpret_cast<std::uintptr_t>(base) % alignof(TableHeader) != 0 ||
+      header_->entriesOffset % alignof(TableEntry) != 0 ||
+      header_->idIndexOffset % alignof(u32) != 0)
+    throw std::runtime_error("Compiled table is misaligned");
+
+  entries_ =
+      reinterpret_cast<const TableEntry *>(base + header_->entriesOffset);
+  idIndex_ = reinterpret_cast<const u32 *>(base + header_->idIndexOffset);
+  strings_ = base + header_->stringsOffset;
+
+  // Lookups index the arrays and the string pool without further checks, so
+  // a corrupt cache file or shared segment must be rejected here.
+  for (u64 i = 0; i < count; i++) {
+    const TableEntry &record = entries_[i];
+    if (u64(record.typeOffset) + record.typeLength > header_->stringsSize ||
+        u64(record.titleOffset) + record.titleLength > header_->stringsSize ||
+        idIndex_[i] >= count)
+      throw std::runtime_error("Compiled table is corrupt");
+  }
+}
+
+TableView::Entry TableView::at(u32 index) const {
+  const TableEntry &record = entries_[index];
+  return Entry{record.id, record.enumId,
+               std::string_view(strings_ + record.typeOffset,
+                                record.typeLength),
+               std::string_view(strings_ + record.titleOffset,
+                                record.titleLength)};
+}
+
+std::optional<TableView::Entry> TableView::findByEnumId(u16 enumId) const {
+  const TableEntry *end = entries_ + size();
+  const TableEntry *it = std::lower_bound(
+      entries_, end, enumId, [](const TableEntry &record, u16 value) {
+        return record.enumId < value;
+      });
+  if (it == end || it->enumId != enumId)
+    return std::nullopt;
+  return at(static_cast<u32>(it - entries_));
+}
+
+std::optional<TableView::Entry> TableView::findById(u32 id) const {
+  const u32 *end = idIndex_ + size();
+  const u32 *it =
+      std::lower_bound(idIndex_, end, id, [this](u32 index, u32 value) {
+        return entries_[index].id < value;
+      });
+  if (it == end || entries_[*it].id != id)
+    return std::nullopt;
+  return at(*it);
+}
+
+std::vector<parser::EnumEntry> TableView::entries() const {
+  std::vector<parser::EnumEntry> result;
+  result.reserve(size());
+  for (u32 i = 0; i < size(); i++) {
+    Entry entry = at(i);
+    result.push_back(parser::EnumEntry{entry.id, std::string(entry.type),
+                                       std::string(entry.title),
+                                       entry.enumId});
+  }
+  return result;
+}
+
+} // namespace winplus::compiler::table
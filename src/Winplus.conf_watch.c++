@@ -0,0 +1,366 @@
+#include "../include/Winplus.conf_watch.hpp"
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <windows.h>
+
+namespace winplus::compiler::watch {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path normalizePath(const fs::path &path) {
+  return fs::absolute(path).lexically_normal();
+}
+
+// Folds a path the way the file system compares names, so paths that differ
+// only in case find the same watched file.
+std::wstring pathKey(const fs::path &path) {
+  std::wstring key = path.wstring();
+  CharUpperBuffW(key.data(), static_cast<DWORD>(key.size()));
+  return key;
+}
+
+std::string formatDiagnostic(const fs::path &path,
+                             const parser::Diagnostic &diagnostic) {
+  return path.string() + ":" + std::to_string(diagnostic.location.line) + ":" +
+         std::to_string(diagnostic.location.column) + ": " +
+         diagnostic.message;
+}
+
+void diffEntries(const std::vector<parser::EnumEntry> &before,
+                 const std::vector<parser::EnumEntry> &after,
+                 EntryDiff &diff) {
+  std::map<u16, const parser::EnumEntry *> previous;
+  for (const auto &entry : before)
+    previous[entry.enumId] = &entry;
+
+  for (const auto &entry : after) {
+    auto it = previous.find(entry.enumId);
+    if (it == previous.end()) {
+      diff.added.push_back(entry);
+      continue;
+    }
+    if (!(*it->second == entry))
+      diff.changed.push_back(entry);
+    previous.erase(it);
+  }
+
+  for (const auto &[enumId, entry] : previous)
+    diff.removed.push_back(*entry);
+}
+
+// One watched directory with its pending ReadDirectoryChangesW request.
+struct Directory {
+  fs::path path;
+  std::wstring key;
+  HANDLE handle = INVALID_HANDLE_VALUE;
+  OVERLAPPED overlapped = {};
+  alignas(DWORD) char buffer[16 * 1024];
+
+  bool arm() {
+    return ReadDirectoryChangesW(handle, buffer, sizeof(buffer), FALSE,
+                                 FILE_NOTIFY_CHANGE_LAST_WRITE |
+                                     FILE_NOTIFY_CHANGE_FILE_NAME |
+                                     FILE_NOTIFY_CHANGE_SIZE,
+                                 NULL, &overlapped, NULL);
+  }
+};
+
+} // namespace
+
+ConfWatcher::ConfWatcher(std::chrono::milliseconds debounce)
+    : debounce_(debounce), nextHandle_(1),
+      stopEvent_(CreateEventA(NULL, TRUE, FALSE, NULL)), lastLatency_(0) {}
+
+ConfWatcher::~ConfWatcher() {
+  stop();
+  CloseHandle(stopEvent_);
+}
+
+void ConfWatcher::addFile(const fs::path &path) {
+  fs::path normalized = normalizePath(path);
+  std::vector<parser::Diagnostic> diagnostics;
+  auto entries = CompileFile(normalized, std::pmr::get_default_resource(),
+                             &diagnostics);
+  if (!diagnostics.empty())
+    throw std::runtime_error(formatDiagnostic(normalized, diagnostics[0]));
+
+  std::lock_guard lock(mutex_);
+  files_[pathKey(normalized)] = WatchedFile{
+      normalized, pathKey(normalized.parent_path()), std::move(entries)};
+}
+
+u32 ConfWatcher::subscribe(Callback callback) {
+  std::lock_guard lock(mutex_);
+  u32 handle = nextHandle_++;
+  subscribers_[handle] = std::move(callback);
+  return handle;
+}
+
+void ConfWatcher::unsubscribe(u32 handle) {
+  std::lock_guard lock(mutex_);
+  subscribers_.erase(handle);
+}
+
+void ConfWatcher::start() {
+  if (thread_.joinable())
+    return;
+
+  std::map<std::wstring, fs::path> watched;
+  {
+    std::lock_guard lock(mutex_);
+    for (const auto &[key, file] : files_)
+      watched.emplace(file.directoryKey, file.path.parent_path());
+  }
+
+  // One wait slot is taken by the stop event.
+  if (watched.size() >= MAXIMUM_WAIT_OBJECTS)
+    throw std::runtime_error("Too many watched directories");
+
+  std::vector<fs::path> directories;
+  for (const auto &[key, path] : watched)
+    directories.push_back(path);
+
+  ResetEvent(stopEvent_);
+  thread_ = std::thread(&ConfWatcher::run, this, std::move(directories));
+}
+
+void ConfWatcher::stop() {
+  if (!thread_.joinable())
+    return;
+
+  SetEvent(stopEvent_);
+  thread_.join();
+}
+
+void ConfWatcher::reload(const std::vector<fs::path> &paths) {
+  reload(paths, std::chrono::steady_clock::now());
+}
+
+std::vector<parser::EnumEntry> ConfWatcher::entries() const {
+  std::lock_guard lock(mutex_);
+  return collectEntries();
+}
+
+std::chrono::microseconds ConfWatcher::lastReloadLatency() const {
+  return std::chrono::microseconds(lastLatency_.load());
+}
+
+std::vector<parser::EnumEntry> ConfWatcher::collectEntries() const {
+  std::vector<parser::EnumEntry> all;
+  for (const auto &[key, file] : files_)
+    all.insert(all.end(), file.entries.begin(), file.entries.end());
+  return all;
+}
+
+void ConfWatcher::reload(const std::vector<fs::path> &paths,
+                         std::chrono::steady_clock::time_point observedAt) {
+  auto compileStart = std::chrono::steady_clock::now();
+
+  // Compile outside of the lock so readers of `entries()` are not blocked by
+  // file I/O.
+  std::vector<std::pair<std::wstring, std::vector<parser::EnumEntry>>>
+      compiled;
+  for (const auto &path : paths) {
+    fs::path normalized = normalizePath(path);
+    std::wstring key = pathKey(normalized);
+    {
+      std::lock_guard lock(mutex_);
+      if (!files_.contains(key))
+        continue;
+    }
+
+    // A file that is still being written usually stops in the middle of an
+    // enumeration; publishing what parsed would drop every entry after it.
+    std::vector<parser::Diagnostic> diagnostics;
+    try {
+      auto entries = CompileFile(normalized, std::pmr::get_default_resource(),
+                                 &diagnostics);
+      if (diagnostics.empty())
+        compiled.emplace_back(key, std::move(entries));
+    } catch (const std::runtime_error &e) {
+      // The file is being replaced; keep its previous entries.
+    }
+  }
+
+  if (compiled.empty())
+    return;
+
+  auto compileEnd = std::chrono::steady_clock::now();
+
+  ReloadEvent event;
+  std::vector<Callback> callbacks;
+  {
+    std::lock_guard lock(mutex_);
+    for (auto &[key, entries] : compiled) {
+      WatchedFile &file = files_[key];
+      diffEntries(file.entries, entries, event.diff);
+      file.entries = std::move(entries);
+      event.files.push_back(file.path);
+    }
+    event.entries = collectEntries();
+    for (const auto &[handle, callback] : subscribers_)
+      callbacks.push_back(callback);
+  }
+
+  event.compileTime = std::chrono::duration_cast<std::chrono::microseconds>(
+      compileEnd - compileStart);
+  event.latency = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - observedAt);
+  lastLatency_.store(event.latency.count());
+
+  for (const auto &callback : callbacks)
+    callback(event);
+}
+
+void ConfWatcher::run(std::vector<fs::path> watched) {
+  std::vector<std::unique_ptr<Directory>> directories;
+  std::vector<HANDLE> waitHandles = {stopEvent_};
+  for (const auto &path : watched) {
+    auto directory = std::make_unique<Directory>();
+    directory->path = path;
+    directory->key = pathKey(path);
+    directory->handle = CreateFileW(
+        path.wstring().c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+        NULL);
+    if (directory->handle == INVALID_HANDLE_VALUE)
+      continue;
+
+    directory->overlapped.hEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+    if (!directory->arm()) {
+      CloseHandle(directory->overlapped.hEvent);
+      CloseHandle(directory->handle);
+      continue;
+    }
+    waitHandles.push_back(directory->overlapped.hEvent);
+    directories.push_back(std::move(directory));
+  }
+
+  // Watched files written to in the current burst, by key.
+  std::map<std::wstring, fs::path> pending;
+  std::chrono::steady_clock::time_point firstWrite;
+  std::chrono::steady_clock::time_point lastWrite;
+
+  // Queues every watched file of a directory; `mutex_` must be held.
+  auto queueDirectory = [&](const std::wstring &directoryKey) {
+    bool queued = false;
+    for (const auto &[key, file] : files_) {
+      if (file.directoryKey == directoryKey) {
+        pending.emplace(key, file.path);
+        queued = true;
+      }
+    }
+    return queued;
+  };
+
+  for (;;) {
+    DWORD timeout = INFINITE;
+    if (!pending.empty()) {
+      auto elapsed = std::chrono::steady_clock::now() - lastWrite;
+      auto remaining =
+          std::chrono::duration_cast<std::chrono::milliseconds>(debounce_ -
+                                                                elapsed);
+      timeout = remaining.count() > 0 ? static_cast<DWORD>(remaining.count())
+                                      : 0;
+    }
+
+    DWORD result = WaitForMultipleObjects(
+        static_cast<DWORD>(waitHandles.size()), waitHandles.data(), FALSE,
+        timeout);
+
+    if (result == WAIT_OBJECT_0)
+      break;
+
+    if (result == WAIT_TIMEOUT) {
+      std::vector<fs::path> paths;
+      for (const auto &[key, path] : pending)
+        paths.push_back(path);
+      pending.clear();
+      reload(paths, firstWrite);
+      continue;
+    }
+
+    if (result < WAIT_OBJECT_0 + 1 ||
+        result >= WAIT_OBJECT_0 + waitHandles.size())
+      break;
+
+    Directory &directory = *directories[result - WAIT_OBJECT_0 - 1];
+    DWORD bytes = 0;
+    GetOverlappedResult(directory.handle, &directory.overlapped, &bytes,
+                        FALSE);
+
+    // Whether a watched file was written, already pending or not; writes to
+    // other files of the directory are ignored so a neighbour that is written
+    // constantly cannot postpone reloads forever.
+    bool written = false;
+    bool wasIdle = pending.empty();
+    {
+      std::lock_guard lock(mutex_);
+      if (bytes == 0) {
+        // The notification buffer overflowed; reload every file of the
+        // directory.
+        written = queueDirectory(directory.key);
+      } else {
+        const char *cursor = directory.buffer;
+        for (;;) {
+          auto *info =
+              reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(cursor);
+          std::wstring_view name(info->FileName,
+                                 info->FileNameLength / sizeof(WCHAR));
+          std::wstring key =
+              pathKey((directory.path / name).lexically_normal());
+          auto file = files_.find(key);
+          if (file != files_.end()) {
+            pending.emplace(key, file->second.path);
+            written = true;
+          }
+
+          if (info->NextEntryOffset == 0)
+            break;
+          cursor += info->NextEntryOffset;
+        }
+      }
+    }
+
+    if (!directory.arm()) {
+      // The directory was removed or became inaccessible; stop waiting on it
+      // and pick up whatever its files contain now.
+      {
+        std::lock_guard lock(mutex_);
+        written |= queueDirectory(directory.key);
+      }
+      CloseHandle(directory.overlapped.hEvent);
+      CloseHandle(directory.handle);
+      sz index = result - WAIT_OBJECT_0 - 1;
+      directories.erase(directories.begin() + index);
+      waitHandles.erase(waitHandles.begin() + index + 1);
+    }
+
+    // Every write to a watched file extends the burst, so a long or chunked
+    // save is reloaded once after it ends.
+    if (written) {
+      auto now = std::chrono::steady_clock::now();
+      if (wasIdle)
+        firstWrite = now;
+      lastWrite = now;
+    }
+  }
+
+  for (auto &directory : directories) {
+    // The pending read still writes into the buffer until it completes, so
+    // wait for the cancellation before freeing it.
+    DWORD bytes = 0;
+    if (CancelIo(directory->handle))
+      GetOverlappedResult(directory->handle, &directory->overlapped, &bytes,
+                          TRUE);
+    CloseHandle(directory->overlapped.hEvent);
+    CloseHandle(directory->handle);
+  }
+}
+
+} // namespace winplus::compiler::watch
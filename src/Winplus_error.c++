@@ -1,7 +1,20 @@
+#include "../include/Winplus.conf_compiler.hpp"
 #include "../include/Winplus.hpp"
+#include <atomic>
+#include <cstdio>
 #include <cstdlib>
 #include <print>
 
+namespace {
+std::atomic<const winplus::error::ErrorCatalog *> currentCatalog = nullptr;
+
+const winplus::string *FindMessage(winplus::error_code code) {
+  const winplus::error::ErrorCatalog *catalog =
+      currentCatalog.load(std::memory_order_acquire);
+  return catalog ? catalog->Find(code) : nullptr;
+}
+} // namespace
+
 WINPLUS_API void winplus::error::Log(winplus::error_code code,
                                      const string message) {
   std::println("[error, {}] {}", code, message);
@@ -13,3 +26,61 @@ WINPLUS_API void winplus::error::StopProcess(winplus::error_code code,
   std::println("Aborting...");
   abort();
 }
+
+WINPLUS_API winplus::error::ErrorCatalog::ErrorCatalog(
+    std::span<const compiler::parser::EnumEntry> entries) {
+  for (const auto &entry : entries) {
+    if (entry.type == "error")
+      messages_.emplace(entry.enumId, entry.title);
+  }
+}
+
+WINPLUS_API const winplus::string *
+winplus::error::ErrorCatalog::Find(winplus::error_code code) const {
+  auto it = messages_.find(code);
+  return it == messages_.end() ? nullptr : &it->second;
+}
+
+WINPLUS_API void winplus::error::SetCatalog(const ErrorCatalog *catalog) {
+  currentCatalog.store(catalog, std::memory_order_release);
+}
+
+WINPLUS_API void winplus::error::Log(winplus::error_code code) {
+  const string *message = FindMessage(code);
+  if (message == nullptr) {
+    std::println("[error, {}] unknown error", code);
+    return;
+  }
+  std::println("[error, {}] {}", code, *message);
+}
+
+WINPLUS_API void winplus::error::LogFormat(winplus::error_code code,
+                                           std::format_args args) {
+  const string *message = FindMessage(code);
+  if (message == nullptr) {
+    std::println("[error, {}] unknown error", code);
+    return;
+  }
+
+  std::print("[error, {}] ", code);
+  try {
+    std::vprint_unicode(stdout, *message, args);
+  } catch (const std::format_error &e) {
+    // The catalog message does not match the arguments; log it unformatted.
+    std::print("{}", *message);
+  }
+  std::print("\n");
+}
+
+WINPLUS_API void winplus::error::StopProcess(winplus::error_code code) {
+  winplus::error::Log(code);
+  std::println("Aborting...");
+  abort();
+}
+
+WINPLUS_API void winplus::error::StopProcessFormat(winplus::error_code code,
+                                                   std::format_args args) {
+  winplus::error::LogFormat(code, args);
+  std::println("Aborting...");
+  abort();
+}
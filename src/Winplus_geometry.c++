@@ -0,0 +1,297 @@
+#include "../include/Winplus_geometry.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WINPLUS_GEOMETRY_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace winplus;
+
+namespace {
+
+constexpr i32 MAX_SCREEN = INT16_MAX;
+
+i16 SaturateI16(i32 value) {
+  return static_cast<i16>(std::clamp<i32>(value, INT16_MIN, INT16_MAX));
+}
+
+#ifdef WINPLUS_GEOMETRY_SSE2
+// SSE2 has no unsigned 16-bit min; flip the sign bit and use the signed one.
+__m128i MinU16(__m128i a, __m128i b) {
+  const __m128i sign = _mm_set1_epi16(static_cast<i16>(0x8000));
+  return _mm_xor_si128(
+      _mm_min_epi16(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign)), sign);
+}
+
+// Widens the low or high four lanes of a 16-bit vector to 32 bits.
+__m128i WidenI16Lo(__m128i v) {
+  return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+}
+__m128i WidenI16Hi(__m128i v) {
+  return _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+}
+__m128i WidenU16Lo(__m128i v) {
+  return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+}
+__m128i WidenU16Hi(__m128i v) {
+  return _mm_unpackhi_epi16(v, _mm_setzero_si128());
+}
+
+// Returns a bit per lane of two 4-lane 32-bit masks, low lanes first.
+int MoveMask8(__m128i lo, __m128i hi) {
+  return _mm_movemask_ps(_mm_castsi128_ps(lo)) |
+         (_mm_movemask_ps(_mm_castsi128_ps(hi)) << 4);
+}
+
+// Lanes where `begin <= point < begin + length`, for 32-bit lanes.
+__m128i Contains(__m128i begin, __m128i length, __m128i point) {
+  __m128i offset = _mm_sub_epi32(point, begin);
+  return _mm_and_si128(_mm_cmpgt_epi32(offset, _mm_set1_epi32(-1)),
+                       _mm_cmplt_epi32(offset, length));
+}
+
+// Lanes where `[begin, begin + length)` overlaps `[first, last)`.
+__m128i Overlaps(__m128i begin, __m128i length, __m128i first,
+                 __m128i last) {
+  return _mm_and_si128(_mm_cmplt_epi32(begin, last),
+                       _mm_cmplt_epi32(first, _mm_add_epi32(begin, length)));
+}
+#endif
+
+} // namespace
+
+WINPLUS_API sz user::WindowGeometry::Add(const GeoRect &rect) {
+  posX_.push_back(rect.X);
+  posY_.push_back(rect.Y);
+  width_.push_back(rect.Width);
+  height_.push_back(rect.Height);
+  return posX_.size() - 1;
+}
+
+WINPLUS_API user::GeoRect user::WindowGeometry::Get(sz index) const {
+  return GeoRect{posX_[index], posY_[index], width_[index], height_[index]};
+}
+
+WINPLUS_API void user::WindowGeometry::Set(sz index, const GeoRect &rect) {
+  posX_[index] = rect.X;
+  posY_[index] = rect.Y;
+  width_[index] = rect.Width;
+  height_[index] = rect.Height;
+}
+
+WINPLUS_API void user::WindowGeometry::Reserve(sz count) {
+  posX_.reserve(count);
+  posY_.reserve(count);
+  width_.reserve(count);
+  height_.reserve(count);
+}
+
+WINPLUS_API void user::WindowGeometry::Clear() {
+  posX_.clear();
+  posY_.clear();
+  width_.clear();
+  height_.clear();
+}
+
+WINPLUS_API void user::WindowGeometry::MoveBy(i16 dx, i16 dy) {
+  sz n = Size();
+  sz i = 0;
+
+#ifdef WINPLUS_GEOMETRY_SSE2
+  const __m128i deltaX = _mm_set1_epi16(dx);
+  const __m128i deltaY = _mm_set1_epi16(dy);
+  for (; i + 8 <= n; i += 8) {
+    auto *x = reinterpret_cast<__m128i *>(posX_.data() + i);
+    auto *y = reinterpret_cast<__m128i *>(posY_.data() + i);
+    _mm_storeu_si128(x, _mm_adds_epi16(_mm_loadu_si128(x), deltaX));
+    _mm_storeu_si128(y, _mm_adds_epi16(_mm_loadu_si128(y), deltaY));
+  }
+#endif
+
+  for (; i < n; i++) {
+    posX_[i] = SaturateI16(posX_[i] + dx);
+    posY_[i] = SaturateI16(posY_[i] + dy);
+  }
+}
+
+WINPLUS_API void user::WindowGeometry::ClampToScreen(u16 screenWidth,
+                                                     u16 screenHeight) {
+  i32 sw = std::min<i32>(screenWidth, MAX_SCREEN);
+  i32 sh = std::min<i32>(screenHeight, MAX_SCREEN);
+  sz n = Size();
+  sz i = 0;
+
+#ifdef WINPLUS_GEOMETRY_SSE2
+  const __m128i screenW = _mm_set1_epi16(static_cast<i16>(sw));
+  const __m128i screenH = _mm_set1_epi16(static_cast<i16>(sh));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= n; i += 8) {
+    auto *x = reinterpret_cast<__m128i *>(posX_.data() + i);
+    auto *y = reinterpret_cast<__m128i *>(posY_.data() + i);
+    auto *w = reinterpret_cast<__m128i *>(width_.data() + i);
+    auto *h = reinterpret_cast<__m128i *>(height_.data() + i);
+
+    __m128i width = MinU16(_mm_loadu_si128(w), screenW);
+    __m128i height = MinU16(_mm_loadu_si128(h), screenH);
+    __m128i maxX = _mm_sub_epi16(screenW, width);
+    __m128i maxY = _mm_sub_epi16(screenH, height);
+
+    _mm_storeu_si128(w, width);
+    _mm_storeu_si128(h, height);
+    _mm_storeu_si128(
+        x, _mm_max_epi16(zero, _mm_min_epi16(_mm_loadu_si128(x), maxX)));
+    _mm_storeu_si128(
+        y, _mm_max_epi16(zero, _mm_min_epi16(_mm_loadu_si128(y), maxY)));
+  }
+#endif
+
+  for (; i < n; i++) {
+    width_[i] = static_cast<u16>(std::min<i32>(width_[i], sw));
+    height_[i] = static_cast<u16>(std::min<i32>(height_[i], sh));
+    posX_[i] = static_cast<i16>(std::clamp<i32>(posX_[i], 0, sw - width_[i]));
+    posY_[i] = static_cast<i16>(std::clamp<i32>(posY_[i], 0, sh - height_[i]));
+  }
+}
+
+WINPLUS_API void user::WindowGeometry::Tile(u16 screenWidth, u16 screenHeight,
+                                            u16 columns) {
+  sz n = Size();
+  if (n == 0)
+    return;
+
+  i32 sw = std::min<i32>(screenWidth, MAX_SCREEN);
+  i32 sh = std::min<i32>(screenHeight, MAX_SCREEN);
+  sz cols = columns ? columns : static_cast<sz>(std::ceil(std::sqrt(n)));
+  sz rows = (n + cols - 1) / cols;
+  u16 cellW = static_cast<u16>(sw / std::clamp<sz>(cols, 1, MAX_SCREEN));
+  u16 cellH = static_cast<u16>(sh / std::clamp<sz>(rows, 1, MAX_SCREEN));
+
+  std::fill(width_.begin(), width_.end(), cellW);
+  std::fill(height_.begin(), height_.end(), cellH);
+
+  // Row by row, so the inner loop is a plain linear store.
+  for (sz row = 0, i = 0; i < n; row++) {
+    i16 y = SaturateI16(static_cast<i32>(std::min<sz>(row * cellH, sh)));
+    sz end = std::min(n, i + cols);
+    for (sz col = 0; i < end; i++, col++) {
+      posX_[i] = SaturateI16(static_cast<i32>(std::min<sz>(col * cellW, sw)));
+      posY_[i] = y;
+    }
+  }
+}
+
+WINPLUS_API void user::WindowGeometry::Cascade(u16 step, u16 screenWidth,
+                                               u16 screenHeight) {
+  i32 half = std::min<i32>(std::min<i32>(screenWidth, screenHeight),
+                           MAX_SCREEN) /
+             2;
+  sz wrap = step ? std::max<sz>(1, half / step) : 1;
+
+  for (sz i = 0; i < Size(); i++) {
+    i16 offset = static_cast<i16>((i % wrap) * step);
+    posX_[i] = offset;
+    posY_[i] = offset;
+  }
+}
+
+WINPLUS_API sz user::WindowGeometry::HitTest(i16 x, i16 y) const {
+  sz n = Size();
+
+  // Scan from the top: the window with the highest index wins.
+  sz i = n;
+#ifdef WINPLUS_GEOMETRY_SSE2
+  for (; i > 0 && i % 8 != 0; i--) {
+    sz j = i - 1;
+    if (x >= posX_[j] && x - posX_[j] < width_[j] && y >= posY_[j] &&
+        y - posY_[j] < height_[j])
+      return j;
+  }
+
+  const __m128i pointX = _mm_set1_epi32(x);
+  const __m128i pointY = _mm_set1_epi32(y);
+  for (; i >= 8; i -= 8) {
+    sz base = i - 8;
+    __m128i px = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(posX_.data() + base));
+    __m128i py = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(posY_.data() + base));
+    __m128i w = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(width_.data() + base));
+    __m128i h = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(height_.data() + base));
+
+    __m128i lo = _mm_and_si128(
+        Contains(WidenI16Lo(px), WidenU16Lo(w), pointX),
+        Contains(WidenI16Lo(py), WidenU16Lo(h), pointY));
+    __m128i hi = _mm_and_si128(
+        Contains(WidenI16Hi(px), WidenU16Hi(w), pointX),
+        Contains(WidenI16Hi(py), WidenU16Hi(h), pointY));
+
+    int mask = MoveMask8(lo, hi);
+    if (mask != 0) {
+      int top = 7;
+      while (!(mask & (1 << top)))
+        top--;
+      return base + top;
+    }
+  }
+#else
+  for (; i > 0; i--) {
+    sz j = i - 1;
+    if (x >= posX_[j] && x - posX_[j] < width_[j] && y >= posY_[j] &&
+        y - posY_[j] < height_[j])
+      return j;
+  }
+#endif
+
+  return NoWindow;
+}
+
+WINPLUS_API void user::WindowGeometry::HitTest(const GeoRect &rect,
+                                               std::vector<sz> &out) const {
+  i32 left = rect.X;
+  i32 top = rect.Y;
+  i32 right = left + rect.Width;
+  i32 bottom = top + rect.Height;
+  sz n = Size();
+  sz i = 0;
+
+#ifdef WINPLUS_GEOMETRY_SSE2
+  const __m128i first = _mm_set1_epi32(left);
+  const __m128i last = _mm_set1_epi32(right);
+  const __m128i firstY = _mm_set1_epi32(top);
+  const __m128i lastY = _mm_set1_epi32(bottom);
+  for (; i + 8 <= n; i += 8) {
+    __m128i px =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(posX_.data() + i));
+    __m128i py =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(posY_.data() + i));
+    __m128i w =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(width_.data() + i));
+    __m128i h =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(height_.data() + i));
+
+    __m128i lo = _mm_and_si128(
+        Overlaps(WidenI16Lo(px), WidenU16Lo(w), first, last),
+        Overlaps(WidenI16Lo(py), WidenU16Lo(h), firstY, lastY));
+    __m128i hi = _mm_and_si128(
+        Overlaps(WidenI16Hi(px), WidenU16Hi(w), first, last),
+        Overlaps(WidenI16Hi(py), WidenU16Hi(h), firstY, lastY));
+
+    int mask = MoveMask8(lo, hi);
+    for (int lane = 0; mask != 0; lane++, mask >>= 1) {
+      if (mask & 1)
+        out.push_back(i + lane);
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    if (posX_[i] < right && left < posX_[i] + width_[i] && posY_[i] < bottom &&
+        top < posY_[i] + height_[i])
+      out.push_back(i);
+  }
+}
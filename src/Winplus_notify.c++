@@ -0,0 +1,123 @@
+#include "../include/Winplus_notify.hpp"
+#include <algorithm>
+
+using namespace winplus;
+using Clock = std::chrono::steady_clock;
+
+WINPLUS_API void user::HeadlessBackend::Show(const Notification &notification) {
+  std::lock_guard lock(mutex_);
+  shown_.push_back(notification);
+}
+
+WINPLUS_API std::vector<user::Notification>
+user::HeadlessBackend::Shown() const {
+  std::lock_guard lock(mutex_);
+  return shown_;
+}
+
+WINPLUS_API user::NotificationQueue::NotificationQueue(
+    NotificationBackend &backend, sz capacity,
+    std::chrono::milliseconds window, NQ_DropPolicy policy)
+    : backend_(backend), capacity_(std::max<sz>(capacity, 1)),
+      window_(window), policy_(policy), stats_(), showing_(false),
+      stopping_(false) {
+  worker_ = std::thread(&NotificationQueue::Run, this);
+}
+
+WINPLUS_API user::NotificationQueue::~NotificationQueue() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  worker_.join();
+}
+
+WINPLUS_API bool user::NotificationQueue::Post(string title, string className,
+                                               u32 type) {
+  {
+    std::lock_guard lock(mutex_);
+    stats_.Posted++;
+
+    for (auto &pending : pending_) {
+      Notification &queued = pending.notification;
+      if (queued.Type == type && queued.Title == title) {
+        queued.Count++;
+        stats_.Coalesced++;
+        return true;
+      }
+    }
+
+    if (pending_.size() >= capacity_) {
+      stats_.Dropped++;
+      if (policy_ == NQ_DROP_NEWEST)
+        return false;
+      pending_.pop_front();
+    }
+
+    // Hold back a repeat of a recently shown notification until the window
+    // has passed, so further repeats are coalesced into it.
+    auto notBefore = Clock::now();
+    auto shown = lastShown_.find({title, type});
+    if (shown != lastShown_.end())
+      notBefore = std::max(notBefore, shown->second + window_);
+
+    pending_.push_back(
+        Pending{Notification{std::move(title), std::move(className), type, 1},
+                notBefore});
+  }
+  wake_.notify_one();
+  return true;
+}
+
+WINPLUS_API void user::NotificationQueue::Flush() {
+  std::unique_lock lock(mutex_);
+  idle_.wait(lock, [this] { return pending_.empty() && !showing_; });
+}
+
+WINPLUS_API user::NotificationStats user::NotificationQueue::Stats() const {
+  std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+void user::NotificationQueue::Run() {
+  std::unique_lock lock(mutex_);
+  while (!stopping_) {
+    if (pending_.empty()) {
+      idle_.notify_all();
+      wake_.wait(lock);
+      continue;
+    }
+
+    // Show the first notification whose window has passed.
+    auto now = Clock::now();
+    auto ready = std::find_if(
+        pending_.begin(), pending_.end(),
+        [now](const Pending &pending) { return pending.notBefore <= now; });
+    if (ready == pending_.end()) {
+      auto earliest = std::min_element(
+          pending_.begin(), pending_.end(),
+          [](const Pending &a, const Pending &b) {
+            return a.notBefore < b.notBefore;
+          });
+      wake_.wait_until(lock, earliest->notBefore);
+      continue;
+    }
+
+    Notification notification = std::move(ready->notification);
+    pending_.erase(ready);
+
+    std::erase_if(lastShown_, [&](const auto &shown) {
+      return shown.second + window_ <= now;
+    });
+    lastShown_[{notification.Title, notification.Type}] = now;
+
+    showing_ = true;
+    stats_.Shown++;
+    lock.unlock();
+    backend_.Show(notification);
+    lock.lock();
+    showing_ = false;
+  }
+  idle_.notify_all();
+}
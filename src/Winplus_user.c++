@@ -1,4 +1,5 @@
 #include "../include/Winplus.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <libloaderapi.h>
@@ -57,10 +58,46 @@ WINPLUS_API void user::WinMessageBoxPlus::Open() {
   MessageBoxA(NULL, this->Title.c_str(), this->ClassName.c_str(), this->Type);
 }
 
+WINPLUS_API bool
+user::WinMessageBoxPlus::Post(NotificationQueue &queue) const {
+  return queue.Post(this->Title, this->ClassName, this->Type);
+}
+
+WINPLUS_API void
+user::MessageBoxBackend::Show(const Notification &notification) {
+  string text = notification.Title;
+  if (notification.Count > 1)
+    text += " (repeated " + std::to_string(notification.Count) + " times)";
+  MessageBoxA(NULL, text.c_str(), notification.ClassName.c_str(),
+              notification.Type);
+}
+
 WINPLUS_API void user::WinMessageBoxPlus::SetType(WMB_Type type) {
   this->Type = type;
 }
 
+WINPLUS_API void
+user::WindowGeometry::Load(std::span<const WindowPlus> windows) {
+  Clear();
+  Reserve(windows.size());
+  for (const auto &window : windows) {
+    Add(GeoRect{window.GetPosX(), window.GetPosY(), window.GetWidth(),
+                window.GetHeight()});
+  }
+}
+
+WINPLUS_API void
+user::WindowGeometry::Store(std::span<WindowPlus> windows) const {
+  assert(windows.size() <= Size());
+  sz count = std::min(windows.size(), Size());
+  for (sz i = 0; i < count; i++) {
+    windows[i].SetPosX(posX_[i]);
+    windows[i].SetPosY(posY_[i]);
+    windows[i].SetWidth(width_[i]);
+    windows[i].SetHeight(height_[i]);
+  }
+}
+
 WINPLUS_API void user::WindowPlus::Open() {
   auto WindowProc = [](HWND hwnd, UINT uMsg, WPARAM wParam,
                        LPARAM lParam) -> LRESULT {
@@ -41,15 +41,17 @@ int main() {
 
   // Print tokens
   for (const auto& token : tokens) {
-    std::print("Token: {}, Lexeme: '{}', Line: {}\n", 
+    auto location = lexer.location(token.offset);
+    std::print("Token: {}, Lexeme: '{}', Line: {}, Column: {}\n", 
                tokenTypeToString(token.type), 
-               token.lexeme, 
-               token.line);
+               lexer.lexeme(token), 
+               location.line,
+               location.column);
   }
 
   // Parse tokens
   std::print("\nParsing enumerations:\n");
-  winplus::compiler::parser::Parser parser(tokens);
+  winplus::compiler::parser::Parser parser(tokens, lexer);
   auto entries = parser.parse();
 
   // Print parsed entries
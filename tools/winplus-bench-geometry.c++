@@ -0,0 +1,227 @@
+#include "../include/Winplus_geometry.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace winplus;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+  u32 windows = 100000;
+  u32 repeat = 100;
+  u16 screenWidth = 1920;
+  u16 screenHeight = 1080;
+};
+
+void printUsage() {
+  std::print(std::cerr,
+             "usage: winplus-bench-geometry [options]\n"
+             "\n"
+             "Runs the WindowGeometry operations over many headless windows\n"
+             "and compares them with per-window loops over GeoRect structs.\n"
+             "\n"
+             "options:\n"
+             "  -n <windows>    number of windows (default: 100000)\n"
+             "  -r <repeat>     runs of every operation (default: 100)\n");
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-n" && i + 1 < argc) {
+      options.windows = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-r" && i + 1 < argc) {
+      options.repeat = std::max(1, std::atoi(argv[++i]));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The same operations over an array of structs, one window at a time.
+namespace reference {
+
+i16 Saturate(i32 value) {
+  return static_cast<i16>(std::clamp<i32>(value, INT16_MIN, INT16_MAX));
+}
+
+void MoveBy(std::vector<user::GeoRect> &rects, i16 dx, i16 dy) {
+  for (auto &rect : rects) {
+    rect.X = Saturate(rect.X + dx);
+    rect.Y = Saturate(rect.Y + dy);
+  }
+}
+
+void ClampToScreen(std::vector<user::GeoRect> &rects, u16 screenWidth,
+                   u16 screenHeight) {
+  i32 sw = std::min<i32>(screenWidth, INT16_MAX);
+  i32 sh = std::min<i32>(screenHeight, INT16_MAX);
+  for (auto &rect : rects) {
+    rect.Width = static_cast<u16>(std::min<i32>(rect.Width, sw));
+    rect.Height = static_cast<u16>(std::min<i32>(rect.Height, sh));
+    rect.X = static_cast<i16>(std::clamp<i32>(rect.X, 0, sw - rect.Width));
+    rect.Y = static_cast<i16>(std::clamp<i32>(rect.Y, 0, sh - rect.Height));
+  }
+}
+
+sz HitTest(const std::vector<user::GeoRect> &rects, i16 x, i16 y) {
+  for (sz i = rects.size(); i > 0; i--) {
+    const auto &rect = rects[i - 1];
+    if (x >= rect.X && x - rect.X < rect.Width && y >= rect.Y &&
+        y - rect.Y < rect.Height)
+      return i - 1;
+  }
+  return user::WindowGeometry::NoWindow;
+}
+
+void HitTest(const std::vector<user::GeoRect> &rects,
+             const user::GeoRect &area, std::vector<sz> &out) {
+  i32 right = area.X + area.Width;
+  i32 bottom = area.Y + area.Height;
+  for (sz i = 0; i < rects.size(); i++) {
+    const auto &rect = rects[i];
+    if (rect.X < right && area.X < rect.X + rect.Width && rect.Y < bottom &&
+        area.Y < rect.Y + rect.Height)
+      out.push_back(i);
+  }
+}
+
+} // namespace reference
+
+bool same(const user::WindowGeometry &geometry,
+          const std::vector<user::GeoRect> &rects) {
+  for (sz i = 0; i < rects.size(); i++) {
+    user::GeoRect rect = geometry.Get(i);
+    if (rect.X != rects[i].X || rect.Y != rects[i].Y ||
+        rect.Width != rects[i].Width || rect.Height != rects[i].Height)
+      return false;
+  }
+  return true;
+}
+
+// Average time of one run, in nanoseconds per window.
+double measure(const Options &options, const std::function<void()> &run) {
+  auto start = Clock::now();
+  for (u32 i = 0; i < options.repeat; i++)
+    run();
+  std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+  return elapsed.count() / options.repeat / options.windows;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 2;
+  }
+
+  // Windows spread over and partly beyond the screen, the same every run.
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> position(-200, 2200);
+  std::uniform_int_distribution<int> size(50, 800);
+
+  user::WindowGeometry geometry;
+  std::vector<user::GeoRect> rects;
+  geometry.Reserve(options.windows);
+  rects.reserve(options.windows);
+  for (u32 i = 0; i < options.windows; i++) {
+    user::GeoRect rect{static_cast<i16>(position(random)),
+                       static_cast<i16>(position(random)),
+                       static_cast<u16>(size(random)),
+                       static_cast<u16>(size(random))};
+    geometry.Add(rect);
+    rects.push_back(rect);
+  }
+
+  std::vector<std::pair<i16, i16>> points;
+  for (int i = 0; i < 64; i++)
+    points.emplace_back(static_cast<i16>(position(random)),
+                        static_cast<i16>(position(random)));
+  user::GeoRect area{100, 100, 300, 200};
+
+  bool failed = false;
+  std::print("{} windows, {} runs\n", options.windows, options.repeat);
+  std::print("{:<16} {:>12} {:>12} {:>8}\n", "operation", "soa ns/win",
+             "aos ns/win", "speedup");
+  auto report = [&](const char *name, double soa, double aos, bool match) {
+    std::print("{:<16} {:>12.3f} {:>12.3f} {:>7.1f}x{}\n", name, soa, aos,
+               aos / soa, match ? "" : "  MISMATCH");
+    failed |= !match;
+  };
+
+  // Moving back and forth keeps the windows in range over every run.
+  double soa = measure(options, [&] {
+    geometry.MoveBy(7, -3);
+    geometry.MoveBy(-7, 3);
+  });
+  double aos = measure(options, [&] {
+    reference::MoveBy(rects, 7, -3);
+    reference::MoveBy(rects, -7, 3);
+  });
+  geometry.MoveBy(30000, -30000);
+  reference::MoveBy(rects, 30000, -30000);
+  report("MoveBy x2", soa, aos, same(geometry, rects));
+
+  soa = measure(options, [&] {
+    geometry.ClampToScreen(options.screenWidth, options.screenHeight);
+  });
+  aos = measure(options, [&] {
+    reference::ClampToScreen(rects, options.screenWidth, options.screenHeight);
+  });
+  report("ClampToScreen", soa, aos, same(geometry, rects));
+
+  // Per window and point: a miss scans every window, a hit stops early.
+  sz engineFound = 0;
+  sz referenceFound = 0;
+  soa = measure(options, [&] {
+    for (auto [x, y] : points)
+      engineFound += geometry.HitTest(x, y) != user::WindowGeometry::NoWindow;
+  });
+  aos = measure(options, [&] {
+    for (auto [x, y] : points)
+      referenceFound +=
+          reference::HitTest(rects, x, y) != user::WindowGeometry::NoWindow;
+  });
+  bool match = engineFound == referenceFound &&
+               std::ranges::all_of(points, [&](auto point) {
+                 auto [x, y] = point;
+                 return geometry.HitTest(x, y) ==
+                        reference::HitTest(rects, x, y);
+               });
+  report("HitTest point", soa / points.size(), aos / points.size(), match);
+
+  std::vector<sz> engineHits;
+  std::vector<sz> referenceHits;
+  soa = measure(options, [&] {
+    engineHits.clear();
+    geometry.HitTest(area, engineHits);
+  });
+  aos = measure(options, [&] {
+    referenceHits.clear();
+    reference::HitTest(rects, area, referenceHits);
+  });
+  report("HitTest rect", soa, aos, engineHits == referenceHits);
+
+  soa = measure(options, [&] {
+    geometry.Tile(options.screenWidth, options.screenHeight);
+  });
+  std::print("{:<16} {:>12.3f}\n", "Tile", soa);
+
+  soa = measure(options, [&] {
+    geometry.Cascade(24, options.screenWidth, options.screenHeight);
+  });
+  std::print("{:<16} {:>12.3f}\n", "Cascade", soa);
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+#include "../include/Winplus_notify.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winplus;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+  u32 threads = std::max(1u, std::thread::hardware_concurrency());
+  u32 posts = 100000;
+  u32 titles = 16;
+  sz capacity = 64;
+  std::chrono::milliseconds window{100};
+  user::NQ_DropPolicy policy = user::NQ_DROP_NEWEST;
+};
+
+void printUsage() {
+  std::print(std::cerr,
+             "usage: winplus-bench-notify [options]\n"
+             "\n"
+             "Posts a storm of notifications from many threads to a queue\n"
+             "with a headless backend and reports how fast they are posted\n"
+             "and how many are coalesced, dropped and shown.\n"
+             "\n"
+             "options:\n"
+             "  -t <threads>    posting threads\n"
+             "  -n <posts>      notifications per thread (default: 100000)\n"
+             "  -k <titles>     distinct titles (default: 16)\n"
+             "  -c <capacity>   queue capacity (default: 64)\n"
+             "  -w <ms>         coalescing window (default: 100)\n"
+             "  --drop-oldest   drop the oldest pending notification\n");
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-t" && i + 1 < argc) {
+      options.threads = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-n" && i + 1 < argc) {
+      options.posts = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-k" && i + 1 < argc) {
+      options.titles = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-c" && i + 1 < argc) {
+      options.capacity = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-w" && i + 1 < argc) {
+      options.window = std::chrono::milliseconds(std::atoi(argv[++i]));
+    } else if (arg == "--drop-oldest") {
+      options.policy = user::NQ_DROP_OLDEST;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+double milliseconds(std::chrono::nanoseconds time) {
+  return std::chrono::duration<double, std::milli>(time).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 2;
+  }
+
+  std::vector<std::string> titles;
+  for (u32 i = 0; i < options.titles; i++)
+    titles.push_back("Error " + std::to_string(i));
+
+  user::HeadlessBackend backend;
+  user::NotificationQueue queue(backend, options.capacity, options.window,
+                                options.policy);
+
+  std::atomic<u32> ready = 0;
+  std::atomic<bool> go = false;
+  std::vector<std::thread> posters;
+  for (u32 t = 0; t < options.threads; t++) {
+    posters.emplace_back([&, t] {
+      ready++;
+      while (!go.load())
+        std::this_thread::yield();
+      for (u32 i = 0; i < options.posts; i++)
+        queue.Post(titles[(t + i) % titles.size()], "bench", 0);
+    });
+  }
+  while (ready.load() != options.threads)
+    std::this_thread::yield();
+
+  auto start = Clock::now();
+  go = true;
+  for (auto &poster : posters)
+    poster.join();
+  auto posted = Clock::now();
+  queue.Flush();
+  auto end = Clock::now();
+
+  user::NotificationStats stats = queue.Stats();
+  sz shown = backend.Shown().size();
+  double seconds = std::chrono::duration<double>(posted - start).count();
+
+  std::print("threads:    {}\n", options.threads);
+  std::print("posted:     {} ({:.0f} posts/sec)\n", stats.Posted,
+             seconds > 0 ? stats.Posted / seconds : 0);
+  std::print("coalesced:  {}\n", stats.Coalesced);
+  std::print("dropped:    {}\n", stats.Dropped);
+  std::print("shown:      {}\n", stats.Shown);
+  std::print("post:       {:.3f} ms\n", milliseconds(posted - start));
+  std::print("flush:      {:.3f} ms\n", milliseconds(end - posted));
+
+  // Every post is coalesced, dropped or shown exactly once.
+  bool match = stats.Posted == u64(options.threads) * options.posts &&
+               stats.Posted == stats.Coalesced + stats.Dropped + stats.Shown &&
+               shown == stats.Shown;
+  if (!match)
+    std::print(std::cerr, "MISMATCH: the counters do not add up\n");
+  return match ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include "../include/Winplus.conf_snapshot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winplus;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+  u32 maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  u32 entries = 1000;
+  std::chrono::milliseconds duration{500};
+  std::chrono::microseconds publishEvery{1000};
+};
+
+void printUsage() {
+  std::print(std::cerr,
+             "usage: winplus-bench-snapshot [options]\n"
+             "\n"
+             "Measures how SnapshotStore lookups through read() and\n"
+             "acquire() scale with reader threads while a writer keeps\n"
+             "publishing new snapshots.\n"
+             "\n"
+             "options:\n"
+             "  -t <threads>    largest number of reader threads\n"
+             "  -n <entries>    entries per snapshot (default: 1000)\n"
+             "  -d <ms>         duration of every run (default: 500)\n"
+             "  -p <us>         publish interval, 0 = never (default: 1000)\n");
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-t" && i + 1 < argc) {
+      options.maxThreads = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-n" && i + 1 < argc) {
+      options.entries = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-d" && i + 1 < argc) {
+      options.duration = std::chrono::milliseconds(std::atoi(argv[++i]));
+    } else if (arg == "-p" && i + 1 < argc) {
+      options.publishEvery = std::chrono::microseconds(std::atoi(argv[++i]));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<compiler::parser::EnumEntry> makeEntries(u32 count) {
+  std::vector<compiler::parser::EnumEntry> entries;
+  entries.reserve(count);
+  for (u32 i = 0; i < count; i++) {
+    entries.push_back(compiler::parser::EnumEntry{
+        i * 7, "type" + std::to_string(i % 16), "title" + std::to_string(i),
+        static_cast<u16>(i)});
+  }
+  return entries;
+}
+
+struct Run {
+  u64 lookups = 0;
+  u64 publishes = 0;
+  std::chrono::nanoseconds elapsed{0};
+};
+
+// Runs `threads` readers that each look up one entry per read() guard, or per
+// acquire() if `acquire` is set.
+Run runReaders(compiler::snapshot::SnapshotStore &store, u32 threads,
+               bool acquire, const Options &options) {
+  std::atomic<bool> stop = false;
+  std::atomic<u64> lookups = 0;
+  std::atomic<u32> ready = 0;
+
+  std::vector<std::thread> readers;
+  for (u32 t = 0; t < threads; t++) {
+    readers.emplace_back([&, t] {
+      u64 count = 0;
+      u32 id = t * 7;
+      ready++;
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (acquire) {
+          auto snapshot = store.acquire();
+          count += snapshot->findById(id) != nullptr;
+        } else {
+          auto snapshot = store.read();
+          count += snapshot->findById(id) != nullptr;
+        }
+        id = (id + 7) % (options.entries * 7);
+      }
+      lookups += count;
+    });
+  }
+  while (ready.load() != threads)
+    std::this_thread::yield();
+
+  Run run;
+  auto entries = makeEntries(options.entries);
+  auto start = Clock::now();
+  auto end = start + options.duration;
+  while (Clock::now() < end) {
+    if (options.publishEvery.count() > 0) {
+      store.publish(entries);
+      run.publishes++;
+      std::this_thread::sleep_for(options.publishEvery);
+    } else {
+      std::this_thread::sleep_for(options.duration);
+    }
+  }
+  stop = true;
+  for (auto &reader : readers)
+    reader.join();
+
+  run.elapsed = Clock::now() - start;
+  run.lookups = lookups.load();
+  return run;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 2;
+  }
+
+  compiler::snapshot::SnapshotStore store;
+  store.publish(makeEntries(options.entries));
+
+  auto perReader = [](const Run &run, u32 threads) {
+    double seconds = std::chrono::duration<double>(run.elapsed).count();
+    return run.lookups / seconds / threads;
+  };
+
+  // Flat per-reader rates mean reads scale with the number of threads.
+  std::print("{:>8} {:>16} {:>16} {:>10}\n", "readers", "read()/s/reader",
+             "acquire()/s/rdr", "publishes");
+  for (u32 threads = 1;; threads *= 2) {
+    threads = std::min(threads, options.maxThreads);
+    Run read = runReaders(store, threads, false, options);
+    Run acquire = runReaders(store, threads, true, options);
+    std::print("{:>8} {:>16.0f} {:>16.0f} {:>10}\n", threads,
+               perReader(read, threads), perReader(acquire, threads),
+               read.publishes + acquire.publishes);
+    if (threads == options.maxThreads)
+      break;
+  }
+  return 0;
+}
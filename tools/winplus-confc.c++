@@ -0,0 +1,377 @@
+#include "../include/Winplus.conf_memory.hpp"
+#include "../include/Winplus.conf_table.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <print>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace winplus;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+  std::vector<std::string> inputs;
+  std::string output = "out.wpct";
+  u32 threads = std::max(1u, std::thread::hardware_concurrency());
+  bool incremental = false;
+  bool stats = false;
+};
+
+// Result of compiling one input file.
+struct Unit {
+  std::vector<compiler::parser::EnumEntry> entries;
+  std::vector<compiler::memory::EntryLocation> locations;
+  u64 bytes = 0;
+  bool cached = false;
+  bool failed = false;
+  std::vector<std::string> errors;
+  std::chrono::nanoseconds readTime{0};
+  std::chrono::nanoseconds compileTime{0};
+  compiler::memory::AllocationStats requested;
+  compiler::memory::AllocationStats arena;
+  compiler::memory::AllocationStats output;
+};
+
+void printUsage() {
+  std::print(std::cerr,
+             "usage: winplus-confc [options] <input>...\n"
+             "\n"
+             "Compiles conf files into one binary table.\n"
+             "\n"
+             "options:\n"
+             "  -o <file>       output table (default: out.wpct)\n"
+             "  -j <threads>    number of compile threads\n"
+             "  --incremental   reuse cached tables of unchanged inputs\n"
+             "  --stats         print throughput, timings and memory usage\n");
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-o" && i + 1 < argc) {
+      options.output = argv[++i];
+    } else if (arg == "-j" && i + 1 < argc) {
+      options.threads = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--incremental") {
+      options.incremental = true;
+    } else if (arg == "--stats") {
+      options.stats = true;
+    } else if (arg == "-h" || arg == "--help") {
+      return false;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::print(std::cerr, "Unknown option: {}\n", arg);
+      return false;
+    } else {
+      options.inputs.push_back(arg);
+    }
+  }
+  return !options.inputs.empty();
+}
+
+bool readFile(const fs::path &path, std::string &content) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  std::ostringstream buffer;
+  buffer << file.rdbuf();
+  content = std::move(buffer).str();
+  return true;
+}
+
+// Writes to a temporary file next to `path` and renames it into place, so
+// an interrupted write or a concurrent reader never sees a partial file.
+bool writeFile(const fs::path &path, const std::vector<char> &bytes) {
+  fs::path temp = path;
+  temp += std::format(".{:x}.tmp",
+                      std::hash<std::thread::id>{}(std::this_thread::get_id()));
+  std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+    return false;
+
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  file.close();
+
+  std::error_code ec;
+  if (file)
+    fs::rename(temp, path, ec);
+  if (!file || ec) {
+    fs::remove(temp, ec);
+    return false;
+  }
+  return true;
+}
+
+// Cached table of one input, keyed by its absolute path.
+fs::path cachePath(const fs::path &cacheDir, const std::string &input) {
+  std::string key = fs::absolute(input).lexically_normal().string();
+  sz hash = std::hash<std::string>{}(key);
+  return cacheDir / std::format("{:016x}.wpct", hash);
+}
+
+bool loadCached(const fs::path &cache, const std::string &input, Unit &unit) {
+  std::error_code ec;
+  auto sourceTime = fs::last_write_time(input, ec);
+  if (ec)
+    return false;
+  auto cacheTime = fs::last_write_time(cache, ec);
+  if (ec || cacheTime < sourceTime)
+    return false;
+
+  std::string bytes;
+  if (!readFile(cache, bytes))
+    return false;
+
+  try {
+    compiler::table::TableView view(bytes);
+    unit.entries = view.entries();
+  } catch (const std::runtime_error &e) {
+    return false;
+  }
+  unit.cached = true;
+  return true;
+}
+
+void compileUnit(const Options &options, const fs::path &cacheDir,
+                 const std::string &input, Unit &unit) {
+  fs::path cache;
+  if (options.incremental) {
+    cache = cachePath(cacheDir, input);
+    if (loadCached(cache, input, unit))
+      return;
+  }
+
+  auto readStart = Clock::now();
+  std::string source;
+  if (!readFile(input, source)) {
+    unit.failed = true;
+    unit.errors.push_back("Failed to open the file: " + input);
+    return;
+  }
+  unit.bytes = source.size();
+
+  auto compileStart = Clock::now();
+  auto report = compiler::memory::CompileInArena(source);
+  auto compileEnd = Clock::now();
+
+  unit.entries = std::move(report.entries);
+  unit.locations = std::move(report.locations);
+  unit.requested = report.total;
+  unit.arena = report.arena;
+  unit.output = report.output;
+  unit.readTime = compileStart - readStart;
+  unit.compileTime = compileEnd - compileStart;
+
+  for (const auto &diagnostic : report.diagnostics) {
+    unit.errors.push_back(std::format("{}:{}:{}: error: {}", input,
+                                      diagnostic.location.line,
+                                      diagnostic.location.column,
+                                      diagnostic.message));
+  }
+  if (!unit.errors.empty()) {
+    unit.failed = true;
+    return;
+  }
+
+  if (options.incremental)
+    writeFile(cache, compiler::table::BuildTable(unit.entries));
+}
+
+// An entry of one input.
+struct EntryRef {
+  sz unit;
+  sz entry;
+};
+
+// Two entries that use the same enumeration ID, or the same ID if `id` is set.
+struct Duplicate {
+  bool id;
+  u64 value;
+  EntryRef first;
+  EntryRef second;
+};
+
+// Finds entries that reuse the enumeration ID or ID of an earlier entry, in
+// the same input or in an earlier one.
+std::vector<Duplicate> findDuplicates(const std::vector<Unit> &units) {
+  std::unordered_map<u16, EntryRef> enumIds;
+  std::unordered_map<u32, EntryRef> ids;
+  std::vector<Duplicate> duplicates;
+  for (sz u = 0; u < units.size(); u++) {
+    for (sz e = 0; e < units[u].entries.size(); e++) {
+      const auto &entry = units[u].entries[e];
+      EntryRef ref{u, e};
+      if (auto [it, added] = enumIds.try_emplace(entry.enumId, ref); !added)
+        duplicates.push_back({false, entry.enumId, it->second, ref});
+      if (auto [it, added] = ids.try_emplace(entry.id, ref); !added)
+        duplicates.push_back({true, entry.id, it->second, ref});
+    }
+  }
+  return duplicates;
+}
+
+// Cached tables keep no positions; compiles an input again to find them.
+void locateUnit(const std::string &input, Unit &unit) {
+  std::string source;
+  if (unit.locations.size() == unit.entries.size() || !readFile(input, source))
+    return;
+
+  auto report = compiler::memory::CompileInArena(source);
+  unit.entries = std::move(report.entries);
+  unit.locations = std::move(report.locations);
+}
+
+// Formats the position of the ID or enumeration ID of an entry, or just the
+// input if its position is unknown.
+std::string position(const Options &options, const std::vector<Unit> &units,
+                     EntryRef ref, bool id) {
+  const std::string &input = options.inputs[ref.unit];
+  const auto &locations = units[ref.unit].locations;
+  if (ref.entry >= locations.size())
+    return input;
+
+  const auto &entry = locations[ref.entry];
+  const auto &location = id ? entry.id : entry.enumId;
+  return std::format("{}:{}:{}", input, location.line, location.column);
+}
+
+double milliseconds(std::chrono::nanoseconds time) {
+  return std::chrono::duration<double, std::milli>(time).count();
+}
+
+double perSecond(u64 count, std::chrono::nanoseconds time) {
+  double seconds = std::chrono::duration<double>(time).count();
+  return seconds > 0 ? count / seconds : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 2;
+  }
+
+  auto start = Clock::now();
+
+  fs::path cacheDir = options.output + ".cache";
+  if (options.incremental)
+    fs::create_directories(cacheDir);
+
+  // Compile: every thread takes the next input until all are done.
+  std::vector<Unit> units(options.inputs.size());
+  std::atomic<sz> next = 0;
+  auto worker = [&] {
+    for (sz i = next++; i < units.size(); i = next++)
+      compileUnit(options, cacheDir, options.inputs[i], units[i]);
+  };
+
+  std::vector<std::thread> threads;
+  u32 threadCount =
+      std::min<u32>(options.threads, static_cast<u32>(units.size()));
+  for (u32 i = 1; i < threadCount; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+
+  auto compileEnd = Clock::now();
+
+  bool failed = false;
+  std::vector<compiler::parser::EnumEntry> entries;
+  for (const auto &unit : units) {
+    if (unit.failed) {
+      for (const auto &error : unit.errors)
+        std::print(std::cerr, "{}\n", error);
+      failed = true;
+      continue;
+    }
+    entries.insert(entries.end(), unit.entries.begin(), unit.entries.end());
+  }
+  if (failed)
+    return 1;
+
+  // Link: every enumeration ID and ID must be unique across all inputs.
+  auto duplicates = findDuplicates(units);
+  if (!duplicates.empty()) {
+    for (sz i = 0; i < units.size(); i++)
+      locateUnit(options.inputs[i], units[i]);
+    for (const auto &duplicate : findDuplicates(units)) {
+      std::print(std::cerr, "{}: error: Duplicate {}: {}\n",
+                 position(options, units, duplicate.second, duplicate.id),
+                 duplicate.id ? "ID" : "enumeration ID", duplicate.value);
+      std::print(std::cerr, "{}: note: First used here\n",
+                 position(options, units, duplicate.first, duplicate.id));
+    }
+    return 1;
+  }
+
+  // Link: build the output table from the entries of all inputs.
+  auto table = compiler::table::BuildTable(entries);
+  auto linkEnd = Clock::now();
+
+  if (!writeFile(options.output, table)) {
+    std::print(std::cerr, "Failed to write the file: {}\n", options.output);
+    return 1;
+  }
+  auto end = Clock::now();
+
+  if (!options.stats)
+    return 0;
+
+  u64 bytes = 0;
+  sz cached = 0;
+  std::chrono::nanoseconds readTime{0};
+  std::chrono::nanoseconds compileTime{0};
+  u64 allocations = 0;
+  u64 outputBytes = 0;
+  u64 largestArena = 0;
+  u64 largestRequest = 0;
+  for (const auto &unit : units) {
+    bytes += unit.bytes;
+    cached += unit.cached;
+    readTime += unit.readTime;
+    compileTime += unit.compileTime;
+    allocations += unit.requested.allocations + unit.output.allocations;
+    outputBytes += unit.output.bytes;
+    if (unit.arena.bytes > largestArena) {
+      largestArena = unit.arena.bytes;
+      largestRequest = unit.requested.bytes;
+    }
+  }
+
+  std::chrono::nanoseconds total = end - start;
+  std::print("files:        {} ({} cached)\n", units.size(), cached);
+  std::print("threads:      {}\n", threadCount);
+  std::print("entries:      {}\n", entries.size());
+  std::print("input:        {} bytes\n", bytes);
+  std::print("output:       {} bytes\n", table.size());
+  std::print("throughput:   {:.0f} bytes/sec, {:.0f} entries/sec\n",
+             perSecond(bytes, total), perSecond(entries.size(), total));
+  std::print("read:         {:.3f} ms (cpu)\n", milliseconds(readTime));
+  std::print("compile:      {:.3f} ms (cpu), {:.3f} ms (wall)\n",
+             milliseconds(compileTime), milliseconds(compileEnd - start));
+  std::print("link:         {:.3f} ms\n", milliseconds(linkEnd - compileEnd));
+  std::print("write:        {:.3f} ms\n", milliseconds(end - linkEnd));
+  std::print("total:        {:.3f} ms\n", milliseconds(total));
+  std::print("allocations:  {}\n", allocations);
+  std::print("arena memory: {} bytes from the heap, {} bytes requested "
+             "(largest compile)\n",
+             largestArena, largestRequest);
+  std::print("parse output: {} bytes on the heap\n", outputBytes);
+  return 0;
+}